@@ -2,59 +2,65 @@
 
 
 // Constructor
-Board::Board() : window(sf::VideoMode(800, 800), "Chess Board", sf::Style::Resize | sf::Style::Close), currentTurn(Color::WHITE) {
+Board::Board(std::string_view fen) : window(sf::VideoMode(800, 800), "Chess Board", sf::Style::Resize | sf::Style::Close) {
     window.setFramerateLimit(60);
     initializeBoard();
-    initializePieces();
+    if (!loadFen(fen)) {
+        std::cerr << "Invalid FEN, using the initial position" << std::endl;
+        loadFen(START_FEN);
+    }
 }
 
 // Initialize the board
 void Board::initializeBoard() {
+    boardVertices.setPrimitiveType(sf::Triangles);
+    boardVertices.resize(8 * 8 * 6);
     for (int row = 0; row < 8; ++row) {
         for (int col = 0; col < 8; ++col) {
-            squares[row][col].setSize(sf::Vector2f(tileSize, tileSize));
-            squares[row][col].setPosition(col * tileSize, row * tileSize);
-            if ((row + col) % 2 == 0) {
-                squares[row][col].setFillColor(sf::Color(222, 184, 135)); // Light color
-            }
-            else {
-                squares[row][col].setFillColor(sf::Color(139, 69, 19));   // Dark color
-            }
+            sf::Color color = ((row + col) % 2 == 0)
+                ? sf::Color(222, 184, 135)  // Light color
+                : sf::Color(139, 69, 19);   // Dark color
+            float left = col * tileSize;
+            float top = row * tileSize;
+            sf::Vertex* quad = &boardVertices[(row * 8 + col) * 6];
+            quad[0] = sf::Vertex(sf::Vector2f(left, top), color);
+            quad[1] = sf::Vertex(sf::Vector2f(left + tileSize, top), color);
+            quad[2] = sf::Vertex(sf::Vector2f(left, top + tileSize), color);
+            quad[3] = sf::Vertex(sf::Vector2f(left, top + tileSize), color);
+            quad[4] = sf::Vertex(sf::Vector2f(left + tileSize, top), color);
+            quad[5] = sf::Vertex(sf::Vector2f(left + tileSize, top + tileSize), color);
         }
     }
+    pieceVertices.setPrimitiveType(sf::Triangles);
     renderBoard();
 }
 
+// Set up the game from a FEN string
+bool Board::loadFen(std::string_view fen) {
+    Position loaded;
+    if (!loaded.setFen(fen)) {
+        return false;
+    }
+    chessPosition = loaded;
+    initializePieces();
+    updateGameStatus();
+    return true;
+}
+
 // Initialize the pieces
 void Board::initializePieces() {
-    // White pieces
-    pieces.push_back(std::make_unique<King>(Color::WHITE, sf::Vector2i(4, 7)));
-    pieces.push_back(std::make_unique<Queen>(Color::WHITE, sf::Vector2i(3, 7)));
-    pieces.push_back(std::make_unique<Rook>(Color::WHITE, sf::Vector2i(0, 7)));
-    pieces.push_back(std::make_unique<Rook>(Color::WHITE, sf::Vector2i(7, 7)));
-    pieces.push_back(std::make_unique<Knight>(Color::WHITE, sf::Vector2i(1, 7)));
-    pieces.push_back(std::make_unique<Knight>(Color::WHITE, sf::Vector2i(6, 7)));
-    pieces.push_back(std::make_unique<Bishop>(Color::WHITE, sf::Vector2i(2, 7)));
-    pieces.push_back(std::make_unique<Bishop>(Color::WHITE, sf::Vector2i(5, 7)));
-
-    // White pawns
-    for (int i = 0; i < 8; ++i) {
-        pieces.push_back(std::make_unique<Pawn>(Color::WHITE, sf::Vector2i(i, 6)));
-    }
-
-    // Black pieces
-    pieces.push_back(std::make_unique<King>(Color::BLACK, sf::Vector2i(4, 0)));
-    pieces.push_back(std::make_unique<Queen>(Color::BLACK, sf::Vector2i(3, 0)));
-    pieces.push_back(std::make_unique<Rook>(Color::BLACK, sf::Vector2i(0, 0)));
-    pieces.push_back(std::make_unique<Rook>(Color::BLACK, sf::Vector2i(7, 0)));
-    pieces.push_back(std::make_unique<Knight>(Color::BLACK, sf::Vector2i(1, 0)));
-    pieces.push_back(std::make_unique<Knight>(Color::BLACK, sf::Vector2i(6, 0)));
-    pieces.push_back(std::make_unique<Bishop>(Color::BLACK, sf::Vector2i(2, 0)));
-    pieces.push_back(std::make_unique<Bishop>(Color::BLACK, sf::Vector2i(5, 0)));
-
-    // Black pawns
-    for (int i = 0; i < 8; ++i) {
-        pieces.push_back(std::make_unique<Pawn>(Color::BLACK, sf::Vector2i(i, 1)));
+    pieces.clear();
+    for (Piece*& piece : pieceOnSquare) {
+        piece = nullptr;
+    }
+    draggedPiece = nullptr;
+    isDragging = false;
+
+    // Create a piece object for every occupied square of the position
+    Bitboard occupied = chessPosition.pieces();
+    while (occupied) {
+        Square s = popLsb(occupied);
+        addPiece(createPiece(chessPosition.pieceOn(s), toBoardPosition(s)));
     }
 
     // Snap all pieces to grid
@@ -66,47 +72,66 @@ void Board::initializePieces() {
 
 // Main loop
 void Board::run() {
-
-    //renderBoard();
-
     while (window.isOpen()) {
+        if (!renderOnDemand || needsRedraw || pieceVerticesDirty) {
+            renderBoard();
+        }
+
         sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-
-            if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left)
-            {
-                sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-                selectPiece(mousePos);
-                isDragging = true;
+        if (renderOnDemand) {
+            // Sleep until something happens, the board never changes on its own
+            if (!window.waitEvent(event)) {
+                continue;
             }
+            handleEvent(event);
+        }
+        while (window.pollEvent(event)) {
+            handleEvent(event);
+        }
+    }
+}
 
-            if (isDragging) {
-                sf::Vector2f mousePosFloat = window.mapPixelToCoords(sf::Mouse::getPosition(window));
 
-                if (draggedPiece) {
-                    draggedPiece->sprite.setPosition(mousePosFloat - offset);
-                }
-                }
+void Board::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::Closed)
+        window.close();
 
-            if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
-                if (isDragging) {
-                    sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-                    placePiece(mousePos);
-                    isDragging = false;
-                }
-            }
-            // Handle window resize event
-            if (event.type == sf::Event::Resized)
-            {
-                // Keep a 1:1 aspect ratio by choosing the smaller dimension
-                unsigned int newSize = std::min(event.size.width, event.size.height);
+    if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left)
+    {
+        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        selectPiece(mousePos);
+        isDragging = true;
+    }
 
-                window.setSize(sf::Vector2u(newSize, newSize));
-            }
+    if (isDragging) {
+        sf::Vector2f mousePosFloat = window.mapPixelToCoords(sf::Mouse::getPosition(window));
+
+        if (draggedPiece) {
+            draggedPiece->sprite.setPosition(mousePosFloat - offset);
+            pieceVerticesDirty = true;
         }
-        renderBoard();
+    }
+
+    if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
+        if (isDragging) {
+            sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+            placePiece(mousePos);
+            isDragging = false;
+        }
+    }
+    // Handle window resize event
+    if (event.type == sf::Event::Resized)
+    {
+        // Keep a 1:1 aspect ratio by choosing the smaller dimension
+        unsigned int newSize = std::min(event.size.width, event.size.height);
+
+        window.setSize(sf::Vector2u(newSize, newSize));
+        needsRedraw = true;
+    }
+
+    // SFML has no expose event, the window contents may be stale after regaining focus
+    if (event.type == sf::Event::GainedFocus) {
+        needsRedraw = true;
     }
 }
 
@@ -119,11 +144,17 @@ void Board::selectPiece(const sf::Vector2i& mousePos) {
     int row = static_cast<int>(worldMousePos.y) / tileSize;
     int col = static_cast<int>(worldMousePos.x) / tileSize;
 
+    // No more moves once the game has ended
+    if (gameStatus != GameStatus::ONGOING) {
+        return;
+    }
+
     // Check if there is a piece at the position and if it's the correct color
     Piece* piece = getPieceAt(sf::Vector2i(col, row));
-    if (piece != nullptr && piece->getColor() == currentTurn) {
+    if (piece != nullptr && piece->getColor() == chessPosition.sideToMove()) {
         draggedPiece = piece;
         selectedPiecePosition = piece->getPosition();
+        pieceVerticesDirty = true;
 
         // Get the resized bounds of the piece in world coordinates
         sf::FloatRect bounds = draggedPiece->sprite.getGlobalBounds();
@@ -145,210 +176,162 @@ void Board::placePiece(const sf::Vector2i& mousePos) {
 
         sf::Vector2i newPosition(col, row);
 
-        // Check if there is a piece at the target position
-        Piece* targetPiece = getPieceAt(newPosition);
-
-        // Check if the move is valid for the dragged piece
-        if (draggedPiece->isValidMove(newPosition, draggedPiece->getPosition(), targetPiece)) {
-
-            if (checkCheck) {
-                // If the King is moving, ensure the new position is not under attack
-                for (const auto& piece : pieces) {
-                    if (piece->getColor() != currentTurn) {  // Only check opponent's pieces
-
-                        // Get the piece at the new position
-                        auto targetPiece = getPieceAt(newPosition);
-
-                        // Allow the king to capture if the target is an opponent's piece
-                        if (targetPiece != nullptr && targetPiece->getColor() != currentTurn) {
-                            // King can capture the opponent's piece, no need to check further
-                            continue;
-                        }
-
-                        // Check if the opponent's piece can move to the new king's position
-                        if (piece->isValidMove(newPosition, piece->getPosition(), getPieceAt(newPosition))) {
-
-                            // Additional check for non-knight pieces: Make sure the path is clear
-                            if (!dynamic_cast<Knight*>(piece.get()) && !isPathClear(newPosition, piece->getPosition())) {
-                                continue;  // Skip if the path to the king is not clear
-                            }
-
-                            // If an opponent piece can move to the new king's position, cancel the move
-                            draggedPiece->snapToGrid();
-                            draggedPiece = nullptr;
-                            return;
-                        }
-                    }
-                }
-            }
-
-            // For non-knight pieces, check if the path is clear
-            if (!dynamic_cast<Knight*>(draggedPiece) && !isPathClear(newPosition, draggedPiece->getPosition())) {
-                // If the path is blocked, reset the piece
-                draggedPiece->snapToGrid();
-                draggedPiece = nullptr;
-                return;
-            }
-
-            // If a piece of the same color is on the target cell, block the move
-            if (targetPiece != nullptr && targetPiece->getColor() == draggedPiece->getColor()) {
-                draggedPiece->snapToGrid();  // Return dragged piece to its original position
-                draggedPiece = nullptr;
-                return;
-            }
-
-            // Castling logic for the King
-            if (auto king = dynamic_cast<King*>(draggedPiece)) {
-                bool isWhiteKing = (king->getColor() == Color::WHITE);
-                bool isBlackKing = (king->getColor() == Color::BLACK);
-
-                // White king-side castling
-                if (isWhiteKing && isPathClear(sf::Vector2i(4, 7), sf::Vector2i(7, 7)) && newPosition == sf::Vector2i(6, 7)) {
-                    Piece* rook = getPieceAt(sf::Vector2i(7, 7)); // Rook on h1
-                    if (rook != nullptr && dynamic_cast<Rook*>(rook) && rook->getColor() == Color::WHITE) {
-                        rook->setPosition(sf::Vector2i(5, 7)); // Move rook to f1
-                        rook->snapToGrid();
-                        king->setPosition(sf::Vector2i(6, 7)); // Move king to g1
-                        king->snapToGrid();
-                    }
-                }
-
-                // Black king-side castling
-                if (isBlackKing && isPathClear(sf::Vector2i(4, 0), sf::Vector2i(7, 0)) && newPosition == sf::Vector2i(6, 0)) {
-                    Piece* rook = getPieceAt(sf::Vector2i(7, 0)); // Rook on h8
-                    if (rook != nullptr && dynamic_cast<Rook*>(rook) && rook->getColor() == Color::BLACK) {
-                        rook->setPosition(sf::Vector2i(5, 0)); // Move rook to f8
-                        rook->snapToGrid();
-                        king->setPosition(sf::Vector2i(6, 0)); // Move king to g8
-                        king->snapToGrid();
-                    }
-                }
-
-                // White queen-side castling
-                if (isWhiteKing && isPathClear(sf::Vector2i(4, 7), sf::Vector2i(0, 7)) && newPosition == sf::Vector2i(2, 7)) {
-                    Piece* rook = getPieceAt(sf::Vector2i(0, 7)); // Rook on a1
-                    if (rook != nullptr && dynamic_cast<Rook*>(rook) && rook->getColor() == Color::WHITE) {
-                        rook->setPosition(sf::Vector2i(3, 7)); // Move rook to d1
-                        rook->snapToGrid();
-                        king->setPosition(sf::Vector2i(2, 7)); // Move king to c1
-                        king->snapToGrid();
-                    }
-                }
-
-                // Black queen-side castling
-                if (isBlackKing && isPathClear(sf::Vector2i(4, 0), sf::Vector2i(0, 0)) && newPosition == sf::Vector2i(2, 0)) {
-                    Piece* rook = getPieceAt(sf::Vector2i(0, 0)); // Rook on a8
-                    if (rook != nullptr && dynamic_cast<Rook*>(rook) && rook->getColor() == Color::BLACK) {
-                        rook->setPosition(sf::Vector2i(3, 0)); // Move rook to d8
-                        rook->snapToGrid();
-                        king->setPosition(sf::Vector2i(2, 0)); // Move king to c8
-                        king->snapToGrid();
-                    }
-                }
-            }
-
-            // Pawn promotion and en passant logic
-            if (auto pawn = dynamic_cast<Pawn*>(draggedPiece)) {
-                bool isWhitePawn = (pawn->getColor() == Color::WHITE);
-                bool isBlackPawn = (pawn->getColor() == Color::BLACK);
-
-                // Pawn promotion
-                if (isWhitePawn && row == 0) {
-                    removePiece(pawn);
-                    auto newQueen = std::make_unique<Queen>(Color::WHITE, newPosition);
-                    newQueen->snapToGrid();
-                    pieces.push_back(std::move(newQueen));
-                }
-
-                if (isBlackPawn && row == 7) {
-                    removePiece(pawn);
-                    auto newQueen = std::make_unique<Queen>(Color::BLACK, newPosition);
-                    newQueen->snapToGrid();
-                    pieces.push_back(std::move(newQueen));
-                }
-
-                // En passant capture logic
-                if (enPassantPossibility) {
-                    if (isWhitePawn) {
-                        Piece* capturedPawn = getPieceAt(sf::Vector2i(newPosition.x, newPosition.y + 1));
-                        if (capturedPawn && capturedPawn->getColor() == Color::BLACK) {
-                            removePiece(capturedPawn);
-                            enPassantPossibility = false;
-                        }
-                    }
-                    else {
-                        Piece* capturedPawn = getPieceAt(sf::Vector2i(newPosition.x, newPosition.y - 1));
-                        if (capturedPawn && capturedPawn->getColor() == Color::WHITE) {
-                            removePiece(capturedPawn);
-                            enPassantPossibility = false;
-                        }
-                    }
-                }
-            }        
-
-            // Handle capture and end of game logic
-            if (targetPiece != nullptr && targetPiece->getColor() != draggedPiece->getColor()) {
-                if (dynamic_cast<King*>(targetPiece)) {
-                    // End game logic
-                    std::cout << "Game over!";
-                    if (targetPiece->getColor() == Color::WHITE) {
-                        std::cout << "Black wins!" << std::endl;
-                    }
-                    else {
-                        std::cout << "White wins!" << std::endl;
-                    }
-                    gameOver = true;
-                }
-                removePiece(targetPiece);
-                enPassantPossibility = false;
-            }
-            
-            // Set the new position and snap to the grid
-            draggedPiece->setPosition(newPosition);
+        // Dropped outside the board, reset the piece
+        if (col < 0 || col > 7 || row < 0 || row > 7) {
             draggedPiece->snapToGrid();
-            //Handle Check check
-            checkForCheck(currentTurn);
             draggedPiece = nullptr;
-            switchTurn(); // Switch turn only if the move is valid
+            pieceVerticesDirty = true;
+            return;
         }
-        else {
+
+        // Let the rules decide, pawns reaching the last rank become queens
+        // unless N, B or R is held while dropping
+        Move move = chessPosition.findMove(toSquare(selectedPiecePosition), toSquare(newPosition), promotionChoice());
+        if (move == MOVE_NONE || !chessPosition.isLegal(move)) {
             // Invalid move, reset piece to original position
             draggedPiece->snapToGrid();
             draggedPiece = nullptr;
+            pieceVerticesDirty = true;
+            return;
+        }
+
+        draggedPiece = nullptr;
+        playMove(move);
+
+        // Answer from the opening book while it knows the position
+        if (bookAutoPlay && gameStatus == GameStatus::ONGOING) {
+            playBookMove();
         }
     }
 }
 
 
-bool Board::isPathClear(sf::Vector2i newPosition, sf::Vector2i position) {
-    int dx = newPosition.x - position.x;
-    int dy = newPosition.y - position.y;
+void Board::playMove(Move move) {
+    updatePieces(move);
+    chessPosition.doMove(move);
+    pieceVerticesDirty = true;
 
-    // Vector of the movement
-    int stepX = (dx == 0) ? 0 : (dx > 0) ? 1 : -1;
-    int stepY = (dy == 0) ? 0 : (dy > 0) ? 1 : -1;
+    //Handle Check check
+    checkForCheck();
 
-    sf::Vector2i currentPos = position;
+    updateGameStatus();
+}
 
-    // Check squares on the way for newPosition
-    while (currentPos != newPosition) {
-        currentPos.x += stepX;
-        currentPos.y += stepY;
 
-        if (currentPos == newPosition) {
-            break;
-        }
+void Board::updateGameStatus() {
+    gameStatus = chessPosition.status();
 
-        if (getPieceAt(currentPos) != nullptr) {
-            return false;
-        }
+    // An endgame the tablebases know is decided already
+    if (gameStatus == GameStatus::ONGOING && tablebases.probe(chessPosition, tablebaseResult)) {
+        gameStatus = tablebaseResult.wdl == TbWdl::WIN ? GameStatus::TABLEBASE_WIN
+            : tablebaseResult.wdl == TbWdl::LOSS ? GameStatus::TABLEBASE_LOSS
+            : GameStatus::TABLEBASE_DRAW;
+    }
+    if (gameStatus == GameStatus::ONGOING) {
+        return;
+    }
+
+    std::cout << "Game over!";
+    bool sideToMoveWins = (gameStatus == GameStatus::TABLEBASE_WIN);
+    if (gameStatus == GameStatus::CHECKMATE || gameStatus == GameStatus::TABLEBASE_WIN || gameStatus == GameStatus::TABLEBASE_LOSS) {
+        bool whiteWins = (chessPosition.sideToMove() == Color::WHITE) == sideToMoveWins;
+        std::cout << (whiteWins ? "White wins!" : "Black wins!");
+    }
+    else {
+        std::cout << "Draw!";
+    }
+    if (gameStatus == GameStatus::TABLEBASE_WIN || gameStatus == GameStatus::TABLEBASE_LOSS) {
+        std::cout << " (tablebase, mate in " << (tablebaseResult.plies + 1) / 2 << ")";
+    }
+    else if (gameStatus == GameStatus::TABLEBASE_DRAW) {
+        std::cout << " (tablebase)";
     }
+    std::cout << std::endl;
+}
+
 
+int Board::loadTablebases(const std::string& directory) {
+    int count = tablebases.load(directory);
+    updateGameStatus();
+    return count;
+}
+
+
+bool Board::loadBook(const std::string& path) {
+    return book.open(path);
+}
+
+
+bool Board::playBookMove() {
+    if (!book.isOpen()) {
+        return false;
+    }
+    Move move = book.weightedMove(chessPosition, static_cast<uint32_t>(bookRandom()));
+    if (move == MOVE_NONE) {
+        return false;
+    }
+    playMove(move);
     return true;
 }
 
 
+PieceType Board::promotionChoice() const {
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::N)) {
+        return KNIGHT;
+    }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::B)) {
+        return BISHOP;
+    }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::R)) {
+        return ROOK;
+    }
+    return QUEEN;
+}
+
+
+void Board::updatePieces(Move move) {
+    Square from = fromSq(move);
+    Square to = toSq(move);
+    Piece* movingPiece = pieceOnSquare[from];
+
+    // Captured piece, for en passant it stands behind the destination
+    Square captureSquare = (typeOfMove(move) == EN_PASSANT) ? to - pawnPush(movingPiece->getColor()) : to;
+    if (pieceOnSquare[captureSquare] != nullptr) {
+        removePiece(pieceOnSquare[captureSquare]);
+    }
+
+    // Castling also moves the rook
+    if (typeOfMove(move) == CASTLING) {
+        Square rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        Piece* rook = pieceOnSquare[rookFrom];
+        movePiece(rook, toBoardPosition(rookTo));
+        rook->snapToGrid();
+    }
+
+    movePiece(movingPiece, toBoardPosition(to));
+    movingPiece->snapToGrid();
+
+    // Pawn promotion replaces the pawn
+    if (typeOfMove(move) == PROMOTION) {
+        Color color = movingPiece->getColor();
+        removePiece(movingPiece);
+        auto promoted = createPiece(makePiece(color, promotionType(move)), toBoardPosition(to));
+        promoted->snapToGrid();
+        addPiece(std::move(promoted));
+    }
+}
+
+
+bool Board::isPathClear(sf::Vector2i newPosition, sf::Vector2i position) {
+    // Squares strictly between the two cells must all be empty
+    return !(betweenBB(toSquare(position), toSquare(newPosition)) & chessPosition.pieces());
+}
+
+
 void Board::removePiece(Piece* pieceToRemove) {
+    pieceOnSquare[toSquare(pieceToRemove->getPosition())] = nullptr;
+
     // Search for piece by position
     auto it = std::find_if(pieces.begin(), pieces.end(),
         [pieceToRemove](const std::unique_ptr<Piece>& piece) {
@@ -358,81 +341,91 @@ void Board::removePiece(Piece* pieceToRemove) {
     if (it != pieces.end()) {
         pieces.erase(it);
     }
+    pieceVerticesDirty = true;
 }
 
 
 Piece* Board::getPieceAt(const sf::Vector2i& pos) const {
     // This function should return the piece at the given position, or nullptr if no piece is present.
-    for (const auto& piece : pieces) {
-        if (piece->getPosition() == pos) {
-            return piece.get(); // Assuming `pieces` is a vector of unique_ptr or shared_ptr to Piece
-        }
+    if (pos.x < 0 || pos.x > 7 || pos.y < 0 || pos.y > 7) {
+        return nullptr;
     }
-    return nullptr; // No piece found at the position
+    return pieceOnSquare[toSquare(pos)];
 }
 
-int counter = 0;
 
-// Render the board and pieces
-void Board::renderBoard() {
-    //window.clear();
-    // TODO: Try to draw board once and re-render only chess pieces.
-    //std::cout << "Board rendered " << counter << " times." << std::endl; // Display the render count
-    //counter++;
-    //if (!boardRendered) {
-        for (int row = 0; row < 8; ++row) {
-            for (int col = 0; col < 8; ++col) {
-                window.draw(squares[row][col]); // Draw the squares
-            }
-        }
-        boardRendered = true; // Set the flag to true after rendering the board
-    //}
+void Board::addPiece(std::unique_ptr<Piece> piece) {
+    pieceOnSquare[toSquare(piece->getPosition())] = piece.get();
+    pieces.push_back(std::move(piece));
+    pieceVerticesDirty = true;
+}
 
-    for (const auto& piece : pieces) {
-        piece->draw(window);
-    }
 
-    window.display();
+void Board::movePiece(Piece* piece, sf::Vector2i newPosition) {
+    pieceOnSquare[toSquare(piece->getPosition())] = nullptr;
+    pieceOnSquare[toSquare(newPosition)] = piece;
+    piece->setPosition(newPosition);
 }
 
 
-void Board::switchTurn() {
-    currentTurn = (currentTurn == Color::WHITE) ? Color::BLACK : Color::WHITE;
+std::unique_ptr<Piece> Board::createPiece(PieceCode piece, sf::Vector2i pos) {
+    return std::make_unique<Piece>(colorOf(piece), typeOf(piece), pos);
 }
 
 
-void Board::checkForCheck(Color currentTurnColor) {
-    // Get the opponent's king position
-    Piece* opponentKing = nullptr;
-    checkCheck = false;
+// Render the board and pieces
+void Board::renderBoard() {
+    drawBoard(window);
+    window.display();
+    needsRedraw = false;
+}
 
-    for (const auto& piece : pieces) {
-        if (King* king = dynamic_cast<King*>(piece.get())) {  // Assuming pieces is a vector of unique_ptr or shared_ptr
-            if (king->getColor() != currentTurnColor) {  // Opponent's king
-                opponentKing = king;
-                break;
-            }
-        }
-    }
 
-    sf::Vector2i kingPosition = opponentKing->getPosition();  // Get the opponent king's position
+void Board::drawBoard(sf::RenderTarget& target) {
+    target.draw(boardVertices); // Draw the squares
 
-    // Check if any of the current player's pieces can move to the opponent king's position
-    for (const auto& piece : pieces) {
-        if (piece->getColor() == currentTurnColor) {  // Only check current player's pieces
+    // All pieces in one draw call, they share the atlas texture
+    if (pieceVerticesDirty) {
+        rebuildPieceVertices();
+    }
+    target.draw(pieceVertices, sf::RenderStates(&TextureCache::instance().getAtlas()));
+}
 
-            // Check if the piece can move to the opponent king's position
-            if (piece->isValidMove(kingPosition, piece->getPosition(), getPieceAt(kingPosition))) {
 
-                // Additional check for non-knight pieces: Make sure the path is clear
-                if (!dynamic_cast<Knight*>(piece.get()) && !isPathClear(kingPosition, piece->getPosition())) {
-                    continue;  // Skip if the path to the king is not clear
-                }
+void Board::rebuildPieceVertices() {
+    pieceVertices.resize(pieces.size() * 6);
+    size_t index = 0;
+    auto appendPiece = [this, &index](const Piece& piece) {
+        sf::IntRect rect = TextureCache::instance().pieceRect(piece.getColor(), piece.getType());
+        sf::Vector2f topLeft = piece.sprite.getPosition();
+        sf::Vector2f size(static_cast<float>(rect.width), static_cast<float>(rect.height));
+        float u = static_cast<float>(rect.left);
+        float v = static_cast<float>(rect.top);
+
+        sf::Vertex* quad = &pieceVertices[index];
+        quad[0] = sf::Vertex(topLeft, sf::Vector2f(u, v));
+        quad[1] = sf::Vertex(sf::Vector2f(topLeft.x + size.x, topLeft.y), sf::Vector2f(u + size.x, v));
+        quad[2] = sf::Vertex(sf::Vector2f(topLeft.x, topLeft.y + size.y), sf::Vector2f(u, v + size.y));
+        quad[3] = quad[2];
+        quad[4] = quad[1];
+        quad[5] = sf::Vertex(topLeft + size, sf::Vector2f(u + size.x, v + size.y));
+        index += 6;
+    };
 
-                // The king is in check
-                std::cerr << "CHECK!" << std::endl;
-                checkCheck = true;
-            }
+    for (const auto& piece : pieces) {
+        if (piece.get() != draggedPiece) {
+            appendPiece(*piece);
         }
     }
+    if (draggedPiece) {
+        appendPiece(*draggedPiece);
+    }
+    pieceVerticesDirty = false;
+}
+
+
+void Board::checkForCheck() {
+    if (chessPosition.inCheck()) {
+        std::cerr << "CHECK!" << std::endl;
+    }
 }
\ No newline at end of file
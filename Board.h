@@ -2,42 +2,70 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <memory>
+#include <random>
+#include <string>
 #include "Piece.h"
-#include "King.h"
-#include "Queen.h"
-#include "Pawn.h"
-#include "Knight.h"
-#include "Rook.h"
-#include "Bishop.h"
-#include "globals.h"
+#include "Core/Position.h"
+#include "Core/Polyglot.h"
+#include "Core/Tablebase.h"
 
 // Board class to handle rendering and interaction
 class Board {
 private:
     sf::RenderWindow window;                  // Window for displaying the chessboard
-    sf::RectangleShape squares[8][8];         // Array to store the board's squares
+    sf::VertexArray boardVertices;            // Two triangles per square, built once
+    sf::VertexArray pieceVertices;            // Two triangles per piece, textured from the atlas
+    bool pieceVerticesDirty = true;           // Pieces moved since pieceVertices was built
+    bool needsRedraw = true;                  // Window contents are stale (resize, focus)
+    bool renderOnDemand = true;               // Redraw only after a change instead of every loop
     const float tileSize = 100.f;             // Size of each square in pixels
     std::vector<std::unique_ptr<Piece>> pieces; // Vector to store all pieces on the board
+    Position chessPosition;                   // Game state, the rules live here and pieces only mirror it
+    GameStatus gameStatus = GameStatus::ONGOING; // Result once the game has ended
+    Piece* pieceOnSquare[SQUARE_NB] = {};     // Piece object standing on each square
+    PolyglotBook book;                        // Opening book, memory-mapped
+    bool bookAutoPlay = false;                // Answer the player's moves from the book while in book
+    std::mt19937 bookRandom{ std::random_device{}() }; // Picks among weighted book moves
+    Tablebases tablebases;                    // Endgame tables, the game ends as soon as one covers the position
+    TbResult tablebaseResult;                 // Verdict behind a TABLEBASE_* status
     sf::Vector2f offset;  
     sf::Vector2i selectedPiecePosition;  // Логическая позиция выбранной фигуры
     bool isDragging = false;             // Флаг, указывает, перетаскиваем ли фигуру
     Piece* draggedPiece = nullptr;       // Указатель на перетаскиваемую фигуру
 
 public:
-    bool boardRendered = false; // Flag to check if the board is already rendered
-    Color currentTurn;// Constructor initializes the window and the board squares
-
-    Board();
+    // Constructor initializes the window, the board squares and the game from a FEN string
+    explicit Board(std::string_view fen = START_FEN);
 
     // Method to initialize the board (create squares and set their colors)
     void initializeBoard();
 
-    // Add initial pieces to the board
+    // Replace the game with the position described by a FEN string, returns false if it is malformed
+    bool loadFen(std::string_view fen);
+
+    std::string getFen() const { return chessPosition.fen(); }
+
+    // Open a Polyglot opening book, returns false if it cannot be read
+    bool loadBook(const std::string& path);
+
+    // Map the endgame tablebases found in a directory, returns how many there are
+    int loadTablebases(const std::string& directory);
+
+    // Reply to every move with a book move, weighted by the book, until out of book
+    void setBookAutoPlay(bool enabled) { bookAutoPlay = enabled; }
+
+    // Create the piece objects for the current position
     void initializePieces();
 
-    // Main loop to handle events and rendering
+    // Main loop to handle events and rendering. Renders on demand by default,
+    // sleeping in waitEvent while nothing happens.
     void run();
 
+    // Switch between on demand rendering and redrawing every loop iteration
+    void setRenderOnDemand(bool enabled) { renderOnDemand = enabled; }
+
+    void handleEvent(const sf::Event& event);
+
     void selectPiece(const sf::Vector2i& mousePos);
     
     void placePiece(const sf::Vector2i& mousePos);
@@ -48,10 +76,40 @@ public:
 
     Piece* getPieceAt(const sf::Vector2i& pos) const;
 
+    // Piece a pawn promotes to, chosen by the key held while dropping it
+    PieceType promotionChoice() const;
+
+    // Apply a legal move to the pieces and the position, then report check and game end
+    void playMove(Move move);
+
+    // Decide whether the game is over, by the rules or by the tablebases, and announce the result
+    void updateGameStatus();
+
+    // Play a book move for the side to move, returns false out of book
+    bool playBookMove();
+
+    // Bring the piece objects in line with a move about to be applied to the position
+    void updatePieces(Move move);
+
+    void addPiece(std::unique_ptr<Piece> piece);
+
+    void movePiece(Piece* piece, sf::Vector2i newPosition);
+
+    // Create the piece object (sprite cut from the shared atlas) for a piece of the position
+    static std::unique_ptr<Piece> createPiece(PieceCode piece, sf::Vector2i pos);
+
+    // Refill pieceVertices from the piece sprites, the dragged piece last so it is drawn on top
+    void rebuildPieceVertices();
+
     // Helper function to render the board and pieces
     void renderBoard();
 
-    void switchTurn();
+    // Draw the board and pieces into a window or an offscreen texture, without displaying it
+    void drawBoard(sf::RenderTarget& target);
+
+    // Hide the window, for example to draw offscreen only
+    void setWindowVisible(bool visible) { window.setVisible(visible); }
 
-    void checkForCheck(Color currentTurnColor);
+    // Report whether the side to move is in check, read from the position
+    void checkForCheck();
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "Bitboard.h"
+#include <initializer_list>
+#include <vector>
+
+Magic RookMagics[SQUARE_NB];
+Magic BishopMagics[SQUARE_NB];
+Bitboard BetweenBB[SQUARE_NB][SQUARE_NB];
+Bitboard LineBB[SQUARE_NB][SQUARE_NB];
+
+namespace {
+
+    Bitboard rookTable[0x19000];  // Attack sets of rooks, all squares and blocker subsets
+    Bitboard bishopTable[0x1480]; // Attack sets of bishops
+
+    // Walk from s by (df, dr) steps, stopping at the board edge or after
+    // the first occupied square
+    Bitboard rayAttacks(Square s, int df, int dr, Bitboard occupied) {
+        Bitboard result = 0;
+        int file = fileOf(s) + df;
+        int rank = rankOf(s) + dr;
+        while (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
+            Square to = makeSquare(file, rank);
+            result |= squareBB(to);
+            if (occupied & squareBB(to)) {
+                break;
+            }
+            file += df;
+            rank += dr;
+        }
+        return result;
+    }
+
+    const int rookSteps[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    const int bishopSteps[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+    // Slow reference attacks of a rook or bishop, used to fill the tables
+    Bitboard slidingAttacks(PieceType pt, Square s, Bitboard occupied) {
+        Bitboard result = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int* step = (pt == ROOK) ? rookSteps[i] : bishopSteps[i];
+            result |= rayAttacks(s, step[0], step[1], occupied);
+        }
+        return result;
+    }
+
+#if !defined(USE_PEXT)
+    // xorshift64* generator, seeded so the magic search is deterministic
+    class MagicRng {
+    private:
+        uint64_t state;
+
+    public:
+        explicit MagicRng(uint64_t seed) : state(seed) {}
+
+        uint64_t next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 2685821657736338717ULL;
+        }
+
+        // Numbers with few bits set make good magic candidates
+        uint64_t sparse() { return next() & next() & next(); }
+    };
+#endif
+
+    // Fill the attack table of one slider kind. Every square gets a slice of
+    // the table sized for all subsets of its blocker mask, indexed by PEXT or
+    // by a magic multiplier found by trial and error.
+    void initMagics(PieceType pt, Bitboard table[], Magic magics[]) {
+#if !defined(USE_PEXT)
+        // Seeds per rank known to find magics quickly
+        const uint64_t seeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+        std::vector<Bitboard> occupancy(4096), reference(4096);
+        std::vector<int> epoch(4096, 0);
+        int attempt = 0;
+#endif
+        int size = 0;
+
+        for (Square s = 0; s < SQUARE_NB; ++s) {
+            // Edge squares never block anything further, leave them out of the mask
+            Bitboard edges = ((rankBB(0) | rankBB(7)) & ~rankBB(rankOf(s)))
+                | ((fileBB(0) | fileBB(7)) & ~fileBB(fileOf(s)));
+
+            Magic& m = magics[s];
+            m.mask = slidingAttacks(pt, s, 0) & ~edges;
+            m.shift = 64 - popcount(m.mask);
+            m.attacks = (s == 0) ? table : magics[s - 1].attacks + size;
+
+            // Enumerate every subset of the mask (Carry-Rippler)
+            Bitboard b = 0;
+            size = 0;
+            do {
+#if defined(USE_PEXT)
+                m.attacks[m.index(b)] = slidingAttacks(pt, s, b);
+#else
+                occupancy[size] = b;
+                reference[size] = slidingAttacks(pt, s, b);
+#endif
+                ++size;
+                b = (b - m.mask) & m.mask;
+            } while (b);
+
+#if !defined(USE_PEXT)
+            // Try candidates until one maps every subset without a destructive collision
+            MagicRng rng(seeds[rankOf(s)]);
+            for (int i = 0; i < size; ) {
+                for (m.magic = 0; popcount((m.magic * m.mask) >> 56) < 6; ) {
+                    m.magic = rng.sparse();
+                }
+                for (++attempt, i = 0; i < size; ++i) {
+                    unsigned index = m.index(occupancy[i]);
+                    if (epoch[index] < attempt) {
+                        epoch[index] = attempt;
+                        m.attacks[index] = reference[i];
+                    }
+                    else if (m.attacks[index] != reference[i]) {
+                        break;
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+    // Build the slider and line tables once, before main runs
+    struct TableInit {
+        TableInit() {
+            initMagics(ROOK, rookTable, RookMagics);
+            initMagics(BISHOP, bishopTable, BishopMagics);
+
+            for (Square a = 0; a < SQUARE_NB; ++a) {
+                for (Square b = 0; b < SQUARE_NB; ++b) {
+                    BetweenBB[a][b] = 0;
+                    LineBB[a][b] = 0;
+                    for (PieceType pt : { BISHOP, ROOK }) {
+                        if (slidingAttacks(pt, a, 0) & squareBB(b)) {
+                            BetweenBB[a][b] = slidingAttacks(pt, a, squareBB(b)) & slidingAttacks(pt, b, squareBB(a));
+                            LineBB[a][b] = (slidingAttacks(pt, a, 0) & slidingAttacks(pt, b, 0)) | squareBB(a) | squareBB(b);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    const TableInit tableInit;
+}
@@ -0,0 +1,199 @@
+#pragma once
+#include <array>
+#include "Types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Slider lookups use the BMI2 PEXT instruction when the compiler targets it,
+// and multiply-shift magic indexing otherwise. Define NO_PEXT to force magics
+// on CPUs where PEXT is microcoded.
+#if defined(__BMI2__) && !defined(NO_PEXT)
+#include <immintrin.h>
+#define USE_PEXT
+#endif
+
+// One bit per square, bit 0 is a1 and bit 63 is h8
+using Bitboard = uint64_t;
+
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard RANK_1_BB = 0xFFULL;
+
+constexpr Bitboard squareBB(Square s) { return Bitboard(1) << s; }
+
+constexpr Bitboard fileBB(int file) { return FILE_A_BB << file; }
+
+constexpr Bitboard rankBB(int rank) { return RANK_1_BB << (8 * rank); }
+
+// Move every square of b one step in the given direction, dropping squares that leave the board
+constexpr Bitboard shiftBB(Bitboard b, int direction) {
+    switch (direction) {
+    case NORTH:      return b << 8;
+    case SOUTH:      return b >> 8;
+    case EAST:       return (b & ~fileBB(7)) << 1;
+    case WEST:       return (b & ~fileBB(0)) >> 1;
+    case NORTH_EAST: return (b & ~fileBB(7)) << 9;
+    case NORTH_WEST: return (b & ~fileBB(0)) << 7;
+    case SOUTH_EAST: return (b & ~fileBB(7)) >> 7;
+    case SOUTH_WEST: return (b & ~fileBB(0)) >> 9;
+    default:         return 0;
+    }
+}
+
+// Number of set bits
+inline int popcount(Bitboard b) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(b));
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+// Least significant set bit, b must not be empty
+inline Square lsb(Bitboard b) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, b);
+    return static_cast<Square>(index);
+#else
+    return static_cast<Square>(__builtin_ctzll(b));
+#endif
+}
+
+// Clear the least significant set bit and return its square
+inline Square popLsb(Bitboard& b) {
+    Square s = lsb(b);
+    b &= b - 1;
+    return s;
+}
+
+inline bool moreThanOne(Bitboard b) {
+    return b & (b - 1);
+}
+
+// Attack table entry of a sliding piece on one square. The relevant
+// occupancy (mask) is hashed to an index into the square's slice of the
+// shared attack table.
+struct Magic {
+    Bitboard mask;     // Squares whose occupancy can block the slider, board edges excluded
+    Bitboard magic;    // Multiplier for the magic index, unused with PEXT
+    Bitboard* attacks; // First entry of this square's attack sets
+    unsigned shift;    // 64 minus the number of bits in mask
+
+    unsigned index(Bitboard occupied) const {
+#if defined(USE_PEXT)
+        return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+        return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+extern Magic RookMagics[SQUARE_NB];
+extern Magic BishopMagics[SQUARE_NB];
+extern Bitboard BetweenBB[SQUARE_NB][SQUARE_NB];
+extern Bitboard LineBB[SQUARE_NB][SQUARE_NB];
+
+inline Bitboard rookAttacks(Square s, Bitboard occupied) {
+    return RookMagics[s].attacks[RookMagics[s].index(occupied)];
+}
+
+inline Bitboard bishopAttacks(Square s, Bitboard occupied) {
+    return BishopMagics[s].attacks[BishopMagics[s].index(occupied)];
+}
+
+inline Bitboard queenAttacks(Square s, Bitboard occupied) {
+    return rookAttacks(s, occupied) | bishopAttacks(s, occupied);
+}
+
+// Squares strictly between a and b if they share a line or diagonal, else empty
+inline Bitboard betweenBB(Square a, Square b) {
+    return BetweenBB[a][b];
+}
+
+// The whole line or diagonal through a and b, edge to edge, or empty if they do not share one
+inline Bitboard lineBB(Square a, Square b) {
+    return LineBB[a][b];
+}
+
+using SquareTable = std::array<Bitboard, SQUARE_NB>;
+
+// Target of a single (df, dr) step from s, empty if it leaves the board
+constexpr Bitboard stepBB(Square s, int df, int dr) {
+    int file = fileOf(s) + df;
+    int rank = rankOf(s) + dr;
+    return (file >= 0 && file < 8 && rank >= 0 && rank < 8) ? squareBB(makeSquare(file, rank)) : 0;
+}
+
+constexpr SquareTable makeKnightAttacks() {
+    SquareTable table{};
+    for (Square s = 0; s < SQUARE_NB; ++s) {
+        table[s] = stepBB(s, 1, 2) | stepBB(s, 2, 1) | stepBB(s, 2, -1) | stepBB(s, 1, -2)
+            | stepBB(s, -1, -2) | stepBB(s, -2, -1) | stepBB(s, -2, 1) | stepBB(s, -1, 2);
+    }
+    return table;
+}
+
+constexpr SquareTable makeKingAttacks() {
+    SquareTable table{};
+    for (Square s = 0; s < SQUARE_NB; ++s) {
+        table[s] = stepBB(s, 1, 0) | stepBB(s, 1, 1) | stepBB(s, 0, 1) | stepBB(s, -1, 1)
+            | stepBB(s, -1, 0) | stepBB(s, -1, -1) | stepBB(s, 0, -1) | stepBB(s, 1, -1);
+    }
+    return table;
+}
+
+// Pawn captures, White pawns attack towards rank 8 and Black towards rank 1
+constexpr SquareTable makePawnAttacks(Color c) {
+    int dr = (c == Color::WHITE) ? 1 : -1;
+    SquareTable table{};
+    for (Square s = 0; s < SQUARE_NB; ++s) {
+        table[s] = stepBB(s, -1, dr) | stepBB(s, 1, dr);
+    }
+    return table;
+}
+
+// Leaper attack tables, computed by the compiler and stored in the binary
+inline constexpr SquareTable KnightAttacks = makeKnightAttacks();
+inline constexpr SquareTable KingAttacks = makeKingAttacks();
+inline constexpr SquareTable PawnAttacks[COLOR_NB] = { makePawnAttacks(Color::WHITE), makePawnAttacks(Color::BLACK) };
+
+// Squares attacked by a pawn of the given color standing on s
+inline Bitboard pawnAttacks(Color c, Square s) {
+    return PawnAttacks[colorIndex(c)][s];
+}
+
+// Squares attacked by a knight, bishop, rook, queen or king standing on s,
+// sliding pieces stop at the first occupied square
+inline Bitboard attacks(PieceType pt, Square s, Bitboard occupied = 0) {
+    switch (pt) {
+    case KNIGHT: return KnightAttacks[s];
+    case BISHOP: return bishopAttacks(s, occupied);
+    case ROOK:   return rookAttacks(s, occupied);
+    case QUEEN:  return queenAttacks(s, occupied);
+    case KING:   return KingAttacks[s];
+    default:     return 0;
+    }
+}
+
+// Same with the piece kind fixed at compile time, for the move generator
+template<PieceType Pt>
+inline Bitboard attacks(Square s, Bitboard occupied = 0) {
+    static_assert(Pt != PAWN, "pawn attacks depend on color, use pawnAttacks");
+    if constexpr (Pt == KNIGHT) {
+        return KnightAttacks[s];
+    }
+    else if constexpr (Pt == BISHOP) {
+        return bishopAttacks(s, occupied);
+    }
+    else if constexpr (Pt == ROOK) {
+        return rookAttacks(s, occupied);
+    }
+    else if constexpr (Pt == QUEEN) {
+        return queenAttacks(s, occupied);
+    }
+    else {
+        return KingAttacks[s];
+    }
+}
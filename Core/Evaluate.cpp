@@ -0,0 +1,15 @@
+#include "Evaluate.h"
+#include <algorithm>
+
+namespace {
+
+    // Small bonus for having the move
+    constexpr int TEMPO = 10;
+}
+
+int evaluate(const Position& pos) {
+    Score psq = pos.psq();
+    int phase = std::min(pos.gamePhase(), PHASE_MAX);
+    int score = (psq.mg * phase + psq.eg * (PHASE_MAX - phase)) / PHASE_MAX;
+    return (pos.sideToMove() == Color::WHITE ? score : -score) + TEMPO;
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include "Position.h"
+
+// Static evaluation in centipawns from the point of view of the side to move.
+// Tapered: the incrementally kept middle game and end game piece-square
+// scores are blended by game phase, so this is constant time.
+int evaluate(const Position& pos);
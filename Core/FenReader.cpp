@@ -0,0 +1,74 @@
+#include "FenReader.h"
+#include <cstring>
+
+// Constructor
+FenReader::FenReader(const std::string& path, size_t bufferSize)
+    : buffer(bufferSize) {
+    file = std::fopen(path.c_str(), "rb");
+}
+
+FenReader::~FenReader() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+void FenReader::refill() {
+    size_t remaining = end - begin;
+    if (begin > 0) {
+        std::memmove(buffer.data(), buffer.data() + begin, remaining);
+        begin = 0;
+        end = remaining;
+    }
+
+    // A line longer than the whole buffer, the only case that allocates
+    if (end == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    size_t read = std::fread(buffer.data() + end, 1, buffer.size() - end, file);
+    end += read;
+    if (read == 0) {
+        atEof = true;
+    }
+}
+
+bool FenReader::nextLine(std::string_view& line) {
+    if (!file) {
+        return false;
+    }
+
+    while (true) {
+        const char* start = buffer.data() + begin;
+        const char* newline = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+        if (newline || (atEof && begin < end)) {
+            size_t length = newline ? static_cast<size_t>(newline - start) : end - begin;
+            begin += newline ? length + 1 : length;
+            if (length > 0 && start[length - 1] == '\r') {
+                --length;
+            }
+            line = std::string_view(start, length);
+            ++lines;
+            return true;
+        }
+        if (atEof) {
+            return false;
+        }
+        refill();
+    }
+}
+
+bool FenReader::next(Position& pos) {
+    std::string_view line;
+    while (nextLine(line)) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos || line[first] == '#') {
+            continue;
+        }
+        if (pos.setFen(line.substr(first))) {
+            return true;
+        }
+        ++badLines;
+    }
+    return false;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Position.h"
+
+// Streams a file of FEN or EPD lines, one position per line, through one
+// buffer that is reused for the whole file. Nothing is allocated per line,
+// so millions of positions load at the speed of the FEN parser.
+class FenReader {
+private:
+    std::FILE* file = nullptr;
+    std::vector<char> buffer;
+    size_t begin = 0;      // First unread byte in buffer
+    size_t end = 0;        // One past the last valid byte in buffer
+    bool atEof = false;
+    uint64_t lines = 0;
+    uint64_t badLines = 0;
+
+    // Move the unread bytes to the front and fill the rest from the file
+    void refill();
+
+public:
+    // Constructor opens the file, check isOpen() before reading
+    explicit FenReader(const std::string& path, size_t bufferSize = 1 << 20);
+    ~FenReader();
+
+    FenReader(const FenReader&) = delete;
+    FenReader& operator=(const FenReader&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Next line without its line break. The view points into the buffer and
+    // is valid until the next call. Returns false at the end of the file.
+    bool nextLine(std::string_view& line);
+
+    // Set up pos from the next well-formed line, skipping blank lines, lines
+    // starting with '#' and malformed FENs. Returns false at the end of the file.
+    bool next(Position& pos);
+
+    // Lines read so far, and how many of them were rejected as malformed
+    uint64_t lineCount() const { return lines; }
+
+    uint64_t errorCount() const { return badLines; }
+};
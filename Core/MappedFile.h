@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// A whole file mapped read-only into memory. Pages are loaded by the OS on
+// first access and shared between processes reading the same file, so
+// large inputs are neither copied nor read in full up front.
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+    bool opened = false;
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    void close();
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file, returns false if it cannot be opened. An empty file maps to no data.
+    bool open(const std::string& path);
+
+    // Hint that the file will be read front to back
+    void adviseSequential() const;
+
+    const char* data() const { return bytes; }
+
+    size_t size() const { return length; }
+
+    bool isOpen() const { return opened; }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include "Types.h"
+
+// Kind of move, stored in the two top bits of a Move
+enum MoveType : uint16_t {
+    NORMAL = 0,
+    PROMOTION = 1 << 14,
+    EN_PASSANT = 2 << 14,
+    CASTLING = 3 << 14
+};
+
+// A move packed into 16 bits:
+// bits 0-5 destination square, bits 6-11 origin square,
+// bits 12-13 promotion piece (knight to queen), bits 14-15 move type.
+// Castling is encoded as the king's own two-square step.
+enum Move : uint16_t { MOVE_NONE = 0 };
+
+constexpr Square fromSq(Move m) { return (m >> 6) & 0x3F; }
+
+constexpr Square toSq(Move m) { return m & 0x3F; }
+
+constexpr MoveType typeOfMove(Move m) { return static_cast<MoveType>(m & (3 << 14)); }
+
+constexpr PieceType promotionType(Move m) { return static_cast<PieceType>(((m >> 12) & 3) + KNIGHT); }
+
+constexpr Move makeMove(Square from, Square to, MoveType type = NORMAL, PieceType promotion = KNIGHT) {
+    return static_cast<Move>(type | ((promotion - KNIGHT) << 12) | (from << 6) | to);
+}
+
+// Square name such as "e4"
+inline std::string squareToString(Square s) {
+    return std::string{ static_cast<char>('a' + fileOf(s)), static_cast<char>('1' + rankOf(s)) };
+}
+
+// Move in coordinate notation such as "e2e4" or "e7e8q"
+inline std::string moveToString(Move m) {
+    if (m == MOVE_NONE) {
+        return "0000";
+    }
+    std::string result = squareToString(fromSq(m)) + squareToString(toSq(m));
+    if (typeOfMove(m) == PROMOTION) {
+        result += "nbrq"[promotionType(m) - KNIGHT];
+    }
+    return result;
+}
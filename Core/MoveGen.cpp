@@ -0,0 +1,219 @@
+#include "MoveGen.h"
+#include <initializer_list>
+
+// Generation is templated on the side to move and the piece kind, so
+// directions, ranks and attack lookups are resolved at compile time. The
+// public generate<GenType> entry points dispatch on the side once.
+namespace {
+
+    // How pawn moves landing on a set of squares are added
+    enum PawnMoveKind { PLAIN, PROMOTE_ALL, PROMOTE_QUEEN };
+
+    // Add a move for every destination in targets, coming from 'offset' squares back
+    template<PawnMoveKind Kind>
+    void addPawnMoves(MoveList& list, Bitboard targets, int offset) {
+        while (targets) {
+            Square to = popLsb(targets);
+            Square from = to - offset;
+            if constexpr (Kind == PLAIN) {
+                list.add(makeMove(from, to));
+            }
+            else {
+                list.add(makeMove(from, to, PROMOTION, QUEEN));
+                if constexpr (Kind == PROMOTE_ALL) {
+                    list.add(makeMove(from, to, PROMOTION, ROOK));
+                    list.add(makeMove(from, to, PROMOTION, BISHOP));
+                    list.add(makeMove(from, to, PROMOTION, KNIGHT));
+                }
+            }
+        }
+    }
+
+    // Pawn moves landing on targets. En passant is always generated when
+    // available, it may capture a checking pawn without landing on it.
+    template<Color Us, bool CapturesOnly>
+    void generatePawnMoves(const Position& pos, MoveList& list, Bitboard targets) {
+        constexpr Color Them = ~Us;
+        constexpr int Up = pawnPush(Us);
+        constexpr int UpWest = Up + WEST;
+        constexpr int UpEast = Up + EAST;
+        constexpr PawnMoveKind Promote = CapturesOnly ? PROMOTE_QUEEN : PROMOTE_ALL;
+
+        const Bitboard rank3 = rankBB(Us == Color::WHITE ? 2 : 5);
+        const Bitboard rank7 = rankBB(Us == Color::WHITE ? 6 : 1);
+        Bitboard emptySquares = ~pos.pieces() & targets;
+        Bitboard enemies = pos.pieces(Them) & targets;
+        Bitboard pawns = pos.pieces(Us, PAWN) & ~rank7;
+        Bitboard promoting = pos.pieces(Us, PAWN) & rank7;
+
+        // Single and double pushes
+        if constexpr (!CapturesOnly) {
+            // Double pushes pass over an empty square that need not be a target
+            Bitboard push1 = shiftBB(pawns, Up) & ~pos.pieces();
+            Bitboard push2 = shiftBB(push1 & rank3, Up) & emptySquares;
+            push1 &= targets;
+            addPawnMoves<PLAIN>(list, push1, Up);
+            addPawnMoves<PLAIN>(list, push2, 2 * Up);
+        }
+
+        // Captures
+        addPawnMoves<PLAIN>(list, shiftBB(pawns, UpWest) & enemies, UpWest);
+        addPawnMoves<PLAIN>(list, shiftBB(pawns, UpEast) & enemies, UpEast);
+
+        // Promotions, by push or by capture, to every piece (only the queen for captures only).
+        // Targets only hold enemy pieces when generating captures, yet a queen
+        // promotion onto an empty square gains as much material as a capture.
+        Bitboard promotionPushTargets = CapturesOnly ? ~pos.pieces() : emptySquares;
+        addPawnMoves<Promote>(list, shiftBB(promoting, Up) & promotionPushTargets, Up);
+        addPawnMoves<Promote>(list, shiftBB(promoting, UpWest) & enemies, UpWest);
+        addPawnMoves<Promote>(list, shiftBB(promoting, UpEast) & enemies, UpEast);
+
+        // En passant: our pawns that would attack the square like an enemy pawn standing on it
+        Square ep = pos.enPassantSquare();
+        if (ep != NO_SQUARE) {
+            Bitboard attackers = pawns & pawnAttacks(Them, ep);
+            while (attackers) {
+                list.add(makeMove(popLsb(attackers), ep, EN_PASSANT));
+            }
+        }
+    }
+
+    template<Color Us, PieceType Pt>
+    void generatePieceMoves(const Position& pos, MoveList& list, Bitboard targets) {
+        Bitboard occupied = pos.pieces();
+        Bitboard pieces = pos.pieces(Us, Pt);
+        while (pieces) {
+            Square from = popLsb(pieces);
+            Bitboard destinations = attacks<Pt>(from, occupied) & targets;
+            while (destinations) {
+                list.add(makeMove(from, popLsb(destinations)));
+            }
+        }
+    }
+
+    template<Color Us>
+    void generateCastling(const Position& pos, MoveList& list) {
+        constexpr Square KingFrom = relativeSquare(Us, makeSquare(4, 0));
+        constexpr uint8_t KingSide = (Us == Color::WHITE) ? WHITE_OO : BLACK_OO;
+        constexpr uint8_t QueenSide = (Us == Color::WHITE) ? WHITE_OOO : BLACK_OOO;
+
+        if (!(pos.castlingRights() & (KingSide | QueenSide)) || pos.inCheck()
+            || pos.pieceOn(KingFrom) != makePiece(Us, KING)) {
+            return;
+        }
+
+        for (uint8_t right : { KingSide, QueenSide }) {
+            if (!(pos.castlingRights() & right)) {
+                continue;
+            }
+
+            // Squares between king and rook must be empty, and the king may not
+            // pass through an attacked square (the landing square is checked by isLegal)
+            Square kingTo = (right == KingSide) ? KingFrom + 2 : KingFrom - 2;
+            Square rookFrom, rookTo;
+            castlingRookSquares(kingTo, rookFrom, rookTo);
+            if (pos.pieceOn(rookFrom) != makePiece(Us, ROOK)) {
+                continue;
+            }
+            if ((betweenBB(KingFrom, rookFrom) & pos.pieces()) || pos.isSquareAttacked(rookTo, ~Us)) {
+                continue;
+            }
+            list.add(makeMove(KingFrom, kingTo, CASTLING));
+        }
+    }
+
+    // Moves of every piece but the king landing on targets
+    template<Color Us, bool CapturesOnly>
+    void generateNonKingMoves(const Position& pos, MoveList& list, Bitboard targets) {
+        generatePawnMoves<Us, CapturesOnly>(pos, list, targets);
+        generatePieceMoves<Us, KNIGHT>(pos, list, targets);
+        generatePieceMoves<Us, BISHOP>(pos, list, targets);
+        generatePieceMoves<Us, ROOK>(pos, list, targets);
+        generatePieceMoves<Us, QUEEN>(pos, list, targets);
+    }
+
+    template<Color Us>
+    void generatePseudoLegal(const Position& pos, MoveList& list) {
+        Bitboard targets = ~pos.pieces(Us);
+        generateNonKingMoves<Us, false>(pos, list, targets);
+        generatePieceMoves<Us, KING>(pos, list, targets);
+        generateCastling<Us>(pos, list);
+    }
+
+    template<Color Us>
+    void generateCaptures(const Position& pos, MoveList& list) {
+        Bitboard targets = pos.pieces(~Us);
+        generateNonKingMoves<Us, true>(pos, list, targets);
+        generatePieceMoves<Us, KING>(pos, list, targets);
+    }
+
+    template<Color Us>
+    void generateLegal(const Position& pos, MoveList& list) {
+        Square king = pos.kingSquare(Us);
+        Bitboard checkers = pos.checkers();
+        Bitboard targets = ~pos.pieces(Us);
+        int first = list.size();
+
+        // In double check only the king can move. In single check the other
+        // pieces must capture the checker or step in between.
+        if (!moreThanOne(checkers)) {
+            Bitboard evasionTargets = checkers ? targets & (betweenBB(king, lsb(checkers)) | checkers) : targets;
+            generateNonKingMoves<Us, false>(pos, list, evasionTargets);
+            generateCastling<Us>(pos, list);
+        }
+        generatePieceMoves<Us, KING>(pos, list, targets);
+
+        // Only king moves, en passant, castling and moves of pinned pieces can
+        // still leave the king in check
+        Bitboard pinned = pos.pinned(Us);
+        for (int i = first; i < list.size(); ) {
+            Move m = list[i];
+            bool needsTest = fromSq(m) == king || typeOfMove(m) == EN_PASSANT || (pinned & squareBB(fromSq(m)));
+            if (!needsTest || pos.isLegal(m)) {
+                ++i;
+            }
+            else {
+                list.removeAt(i);
+            }
+        }
+    }
+}
+
+bool MoveList::contains(Move m) const {
+    for (Move move : *this) {
+        if (move == m) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<>
+void generate<PSEUDO_LEGAL>(const Position& pos, MoveList& list) {
+    if (pos.sideToMove() == Color::WHITE) {
+        generatePseudoLegal<Color::WHITE>(pos, list);
+    }
+    else {
+        generatePseudoLegal<Color::BLACK>(pos, list);
+    }
+}
+
+template<>
+void generate<CAPTURES>(const Position& pos, MoveList& list) {
+    if (pos.sideToMove() == Color::WHITE) {
+        generateCaptures<Color::WHITE>(pos, list);
+    }
+    else {
+        generateCaptures<Color::BLACK>(pos, list);
+    }
+}
+
+template<>
+void generate<LEGAL>(const Position& pos, MoveList& list) {
+    if (pos.sideToMove() == Color::WHITE) {
+        generateLegal<Color::WHITE>(pos, list);
+    }
+    else {
+        generateLegal<Color::BLACK>(pos, list);
+    }
+}
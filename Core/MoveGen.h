@@ -0,0 +1,43 @@
+#pragma once
+#include "Position.h"
+
+// Upper bound on the number of moves in any reachable position
+constexpr int MAX_MOVES = 256;
+
+// Which moves to generate
+enum GenType {
+    PSEUDO_LEGAL, // Moves that follow the piece rules, may leave the own king in check
+    LEGAL,        // Pseudo-legal moves that keep the own king safe
+    CAPTURES      // Pseudo-legal captures and queen promotions, by capture or by push, for the quiescence search
+};
+
+// Fixed-capacity move list living on the stack, so generation never allocates
+class MoveList {
+private:
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+public:
+    void add(Move m) { moves[count++] = m; }
+
+    // Remove the move at index i by moving the last one into its place
+    void removeAt(int i) { moves[i] = moves[--count]; }
+
+    void clear() { count = 0; }
+
+    int size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    Move operator[](int i) const { return moves[i]; }
+
+    const Move* begin() const { return moves; }
+
+    const Move* end() const { return moves + count; }
+
+    bool contains(Move m) const;
+};
+
+// Append all moves of the requested kind for the side to move to list
+template<GenType Type>
+void generate(const Position& pos, MoveList& list);
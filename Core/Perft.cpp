@@ -0,0 +1,105 @@
+#include "Perft.h"
+#include <thread>
+#include "MoveGen.h"
+
+PerftTable::PerftTable(size_t megabytes) {
+    entryCount = megabytes * 1024 * 1024 / sizeof(Entry);
+    if (entryCount > 0) {
+        entries.reset(new Entry[entryCount]);
+        for (size_t i = 0; i < entryCount; ++i) {
+            entries[i].check.store(0, std::memory_order_relaxed);
+            entries[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool PerftTable::probe(uint64_t key, int depth, uint64_t& nodes) const {
+    if (entryCount == 0) {
+        return false;
+    }
+    const Entry& entry = entries[key % entryCount];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t check = entry.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth) {
+        return false;
+    }
+    nodes = data >> 8;
+    return true;
+}
+
+void PerftTable::store(uint64_t key, int depth, uint64_t nodes) {
+    if (entryCount == 0) {
+        return;
+    }
+    Entry& entry = entries[key % entryCount];
+    uint64_t data = (nodes << 8) | static_cast<uint64_t>(depth);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+uint64_t perft(Position& pos, int depth, PerftTable* table) {
+    if (depth == 0) {
+        return 1;
+    }
+
+    MoveList moves;
+    generate<LEGAL>(pos, moves);
+
+    // Bulk counting: the legal moves at the last ply are the leaves
+    if (depth == 1) {
+        return moves.size();
+    }
+
+    uint64_t key = 0;
+    uint64_t nodes = 0;
+    if (table) {
+        key = pos.key();
+        if (table->probe(key, depth, nodes)) {
+            return nodes;
+        }
+    }
+
+    UndoInfo undo;
+    for (Move m : moves) {
+        pos.doMove(m, undo);
+        nodes += perft(pos, depth - 1, table);
+        pos.undoMove(m, undo);
+    }
+
+    if (table) {
+        table->store(key, depth, nodes);
+    }
+    return nodes;
+}
+
+std::vector<DivideEntry> perftDivide(const Position& pos, int depth, int threads, PerftTable* table) {
+    MoveList moves;
+    generate<LEGAL>(pos, moves);
+
+    std::vector<DivideEntry> result;
+    for (Move m : moves) {
+        result.push_back({ m, 0 });
+    }
+
+    // Each worker takes the next unclaimed root move until none are left
+    std::atomic<size_t> nextMove(0);
+    auto worker = [&]() {
+        Position local = pos;
+        UndoInfo undo;
+        for (size_t i = nextMove++; i < result.size(); i = nextMove++) {
+            local.doMove(result[i].move, undo);
+            result[i].nodes = perft(local, depth - 1, table);
+            local.undoMove(result[i].move, undo);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Position.h"
+
+// Cache of subtree node counts shared by all perft threads. Entries are
+// written without locks: the stored check word is the key XOR the data
+// word, so a torn write from two threads simply fails verification.
+class PerftTable {
+private:
+    struct Entry {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;  // node count << 8 | depth
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    size_t entryCount = 0;
+
+public:
+    // Constructor allocates about the given number of megabytes, 0 disables caching
+    explicit PerftTable(size_t megabytes);
+
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const;
+
+    void store(uint64_t key, int depth, uint64_t nodes);
+};
+
+// Node count of one root move
+struct DivideEntry {
+    Move move;
+    uint64_t nodes;
+};
+
+// Number of leaf nodes of the legal move tree of the given depth.
+// Moves are made and taken back on pos, which is unchanged on return.
+uint64_t perft(Position& pos, int depth, PerftTable* table = nullptr);
+
+// Node counts below every legal root move, with root moves spread over the given number of threads
+std::vector<DivideEntry> perftDivide(const Position& pos, int depth, int threads, PerftTable* table = nullptr);
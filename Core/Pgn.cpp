@@ -0,0 +1,394 @@
+#include "Pgn.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "MoveGen.h"
+
+namespace {
+
+    bool isPgnSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    PieceType pieceFromLetter(char c) {
+        switch (c) {
+        case 'N': return KNIGHT;
+        case 'B': return BISHOP;
+        case 'R': return ROOK;
+        case 'Q': return QUEEN;
+        case 'K': return KING;
+        default:  return NO_PIECE_TYPE;
+        }
+    }
+
+    Move parseCastling(const Position& pos, std::string_view san) {
+        bool kingSide = (san == "O-O" || san == "0-0");
+        bool queenSide = (san == "O-O-O" || san == "0-0-0");
+        Square kingFrom = pos.kingSquare(pos.sideToMove());
+        if ((!kingSide && !queenSide) || kingFrom == NO_SQUARE) {
+            return MOVE_NONE;
+        }
+
+        // Rare enough to simply look the move up among the legal ones
+        Move m = makeMove(kingFrom, kingFrom + (kingSide ? 2 : -2), CASTLING);
+        MoveList moves;
+        generate<LEGAL>(pos, moves);
+        return moves.contains(m) ? m : MOVE_NONE;
+    }
+
+    bool isResult(std::string_view token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+    // Value of a tag line "[Name "Value"]" if its name is 'name'
+    bool tagValue(std::string_view tag, std::string_view name, std::string_view& value) {
+        if (tag.size() < name.size() + 1 || tag.compare(1, name.size(), name) != 0 || !isPgnSpace(tag[name.size() + 1])) {
+            return false;
+        }
+        size_t open = tag.find('"');
+        size_t close = tag.rfind('"');
+        if (open == std::string_view::npos || close <= open) {
+            return false;
+        }
+        value = tag.substr(open + 1, close - open - 1);
+        return true;
+    }
+
+    PgnStats replayRange(const char* begin, const char* end) {
+        PgnStats stats;
+        PgnReader reader(begin, end);
+        Position pos;
+        std::string_view game;
+        while (reader.nextGame(game)) {
+            int plies = 0;
+            ++stats.games;
+            if (!replayGame(game, pos, plies)) {
+                ++stats.errors;
+            }
+            stats.plies += plies;
+        }
+        return stats;
+    }
+
+    // Offset of the first "[Event " line at or after 'from', or size if none
+    size_t findGameStart(const char* data, size_t size, size_t from) {
+        std::string_view text(data, size);
+        if (from == 0 && text.compare(0, 7, "[Event ") == 0) {
+            return 0;
+        }
+        size_t found = text.find("\n[Event ", from ? from - 1 : 0);
+        return found == std::string_view::npos ? size : found + 1;
+    }
+}
+
+
+Move parseSan(const Position& pos, std::string_view san) {
+    // Check marks and annotations carry no information about the move
+    while (!san.empty() && std::strchr("+#!?", san.back())) {
+        san.remove_suffix(1);
+    }
+    if (san.size() < 2) {
+        return MOVE_NONE;
+    }
+    if (san[0] == 'O' || san[0] == '0') {
+        return parseCastling(pos, san);
+    }
+
+    Color us = pos.sideToMove();
+    PieceType pt = pieceFromLetter(san[0]);
+    size_t i = (pt == NO_PIECE_TYPE) ? 0 : 1;
+    if (pt == NO_PIECE_TYPE) {
+        pt = PAWN;
+    }
+
+    // Promotion suffix, "=Q" or a bare "Q"
+    PieceType promotion = NO_PIECE_TYPE;
+    size_t squareEnd = san.size();
+    if (pt == PAWN && pieceFromLetter(san.back()) != NO_PIECE_TYPE) {
+        promotion = pieceFromLetter(san.back());
+        --squareEnd;
+        if (squareEnd > 0 && san[squareEnd - 1] == '=') {
+            --squareEnd;
+        }
+    }
+    if (squareEnd < i + 2) {
+        return MOVE_NONE;
+    }
+
+    char toFile = san[squareEnd - 2];
+    char toRank = san[squareEnd - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8') {
+        return MOVE_NONE;
+    }
+    Square to = makeSquare(toFile - 'a', toRank - '1');
+    if (pos.pieces(us) & squareBB(to)) {
+        return MOVE_NONE;
+    }
+
+    // Disambiguation and capture mark between piece letter and destination
+    int fromFile = -1;
+    int fromRank = -1;
+    for (size_t k = i; k < squareEnd - 2; ++k) {
+        char c = san[k];
+        if (c >= 'a' && c <= 'h') {
+            fromFile = c - 'a';
+        }
+        else if (c >= '1' && c <= '8') {
+            fromRank = c - '1';
+        }
+        else if (c != 'x' && c != '-') {
+            return MOVE_NONE;
+        }
+    }
+
+    // Our pieces of the right kind able to reach the destination
+    Bitboard candidates;
+    bool promoting = (pt == PAWN && relativeRank(us, to) == 7);
+    if (pt == PAWN) {
+        if (relativeRank(us, to) < 2) {
+            return MOVE_NONE;
+        }
+        if (fromFile >= 0 && fromFile != fileOf(to)) {
+            // Capture, onto an enemy piece or the en passant square
+            bool enPassant = (to == pos.enPassantSquare());
+            if (pos.empty(to) && !enPassant) {
+                return MOVE_NONE;
+            }
+            candidates = pawnAttacks(~us, to) & pos.pieces(us, PAWN);
+        }
+        else {
+            // Push by one, or by two from the second rank over an empty square
+            Square behind = to - pawnPush(us);
+            if (!pos.empty(to)) {
+                return MOVE_NONE;
+            }
+            candidates = pos.pieces(us, PAWN) & squareBB(behind);
+            if (!candidates && pos.empty(behind) && relativeRank(us, to) == 3) {
+                candidates = pos.pieces(us, PAWN) & squareBB(behind - pawnPush(us));
+            }
+        }
+    }
+    else {
+        candidates = pos.pieces(us, pt) & attacks(pt, to, pos.pieces());
+    }
+    if (fromFile >= 0) {
+        candidates &= fileBB(fromFile);
+    }
+    if (fromRank >= 0) {
+        candidates &= rankBB(fromRank);
+    }
+    if (promoting != (promotion != NO_PIECE_TYPE) || promotion == KING) {
+        return MOVE_NONE;
+    }
+
+    // Exactly one of them must be allowed to move there
+    Move found = MOVE_NONE;
+    while (candidates) {
+        Square from = popLsb(candidates);
+        Move m;
+        if (promoting) {
+            m = makeMove(from, to, PROMOTION, promotion);
+        }
+        else if (pt == PAWN && to == pos.enPassantSquare() && fileOf(from) != fileOf(to)) {
+            m = makeMove(from, to, EN_PASSANT);
+        }
+        else {
+            m = makeMove(from, to);
+        }
+        if (!pos.isLegal(m)) {
+            continue;
+        }
+        if (found != MOVE_NONE) {
+            return MOVE_NONE;
+        }
+        found = m;
+    }
+    return found;
+}
+
+bool PgnReader::nextGame(std::string_view& game) {
+    while (cursor < end && isPgnSpace(*cursor)) {
+        ++cursor;
+    }
+    if (cursor >= end) {
+        return false;
+    }
+
+    const char* start = cursor;
+    bool inMovetext = false;
+    while (cursor < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* next = lineEnd ? lineEnd + 1 : end;
+
+        const char* first = cursor;
+        while (first < next && isPgnSpace(*first)) {
+            ++first;
+        }
+        if (first < next) {
+            if (*first == '[') {
+                if (inMovetext) {
+                    break;
+                }
+            }
+            else {
+                inMovetext = true;
+            }
+        }
+        cursor = next;
+    }
+
+    game = std::string_view(start, cursor - start);
+    return true;
+}
+
+bool replayGame(std::string_view game, Position& pos, int& plies) {
+    pos.setStartPosition();
+    plies = 0;
+
+    size_t i = 0;
+    while (i < game.size()) {
+        char c = game[i];
+        if (isPgnSpace(c)) {
+            ++i;
+            continue;
+        }
+
+        size_t skipTo;
+        switch (c) {
+        case '[': {
+            // Tag pair, only FEN changes how the game is replayed
+            skipTo = game.find(']', i);
+            if (skipTo == std::string_view::npos) {
+                return false;
+            }
+            ++skipTo;
+            std::string_view value;
+            if (plies == 0 && tagValue(game.substr(i, skipTo - i), "FEN", value) && !pos.setFen(value)) {
+                return false;
+            }
+            i = skipTo;
+            continue;
+        }
+
+        case '{':
+            // A comment left open would swallow the rest of the game
+            skipTo = game.find('}', i);
+            if (skipTo == std::string_view::npos) {
+                return false;
+            }
+            i = skipTo + 1;
+            continue;
+
+        case ';':
+        case '%':
+            skipTo = game.find('\n', i);
+            i = (skipTo == std::string_view::npos) ? game.size() : skipTo + 1;
+            continue;
+
+        case '(': {
+            // Variations nest, comments inside them may hold parentheses
+            int depth = 0;
+            for (; ; ++i) {
+                // A variation left open would swallow the rest of the game
+                if (i == game.size()) {
+                    return false;
+                }
+                if (game[i] == '{') {
+                    skipTo = game.find('}', i);
+                    if (skipTo == std::string_view::npos) {
+                        return false;
+                    }
+                    i = skipTo;
+                }
+                else if (game[i] == '(') {
+                    ++depth;
+                }
+                else if (game[i] == ')' && --depth == 0) {
+                    ++i;
+                    break;
+                }
+            }
+            continue;
+        }
+
+        case '$':
+            for (++i; i < game.size() && game[i] >= '0' && game[i] <= '9'; ++i) {}
+            continue;
+
+        default:
+            break;
+        }
+
+        size_t tokenEnd = i;
+        while (tokenEnd < game.size() && !isPgnSpace(game[tokenEnd]) && !std::strchr("{}();[$", game[tokenEnd])) {
+            ++tokenEnd;
+        }
+        std::string_view token = game.substr(i, tokenEnd - i);
+        i = std::max(tokenEnd, i + 1);
+
+        // A closing ')', '}' or ']' without its opening one
+        if (token.empty()) {
+            return false;
+        }
+
+        if (isResult(token)) {
+            return true;
+        }
+
+        // Move number, "12." or "12...", possibly glued to the move
+        if (token[0] >= '1' && token[0] <= '9') {
+            size_t k = 0;
+            while (k < token.size() && token[k] >= '0' && token[k] <= '9') {
+                ++k;
+            }
+            if (k < token.size() && token[k] == '.') {
+                while (k < token.size() && token[k] == '.') {
+                    ++k;
+                }
+                token.remove_prefix(k);
+                if (token.empty()) {
+                    continue;
+                }
+            }
+        }
+
+        Move m = parseSan(pos, token);
+        if (m == MOVE_NONE) {
+            return false;
+        }
+        pos.doMove(m);
+        ++plies;
+    }
+    return true;
+}
+
+PgnStats replayPgn(const char* data, size_t size, int threads) {
+    threads = std::max(1, threads);
+    if (threads == 1) {
+        return replayRange(data, data + size);
+    }
+
+    // Shard boundaries moved forward to the next game start
+    std::vector<size_t> bounds = { 0 };
+    for (int t = 1; t < threads; ++t) {
+        size_t target = std::max(size / threads * t, bounds.back());
+        bounds.push_back(findGameStart(data, size, target));
+    }
+    bounds.push_back(size);
+
+    std::vector<PgnStats> results(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] { results[t] = replayRange(data + bounds[t], data + bounds[t + 1]); });
+    }
+
+    PgnStats total;
+    for (int t = 0; t < threads; ++t) {
+        workers[t].join();
+        total.games += results[t].games;
+        total.plies += results[t].plies;
+        total.errors += results[t].errors;
+    }
+    return total;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include "Position.h"
+
+// Resolve a move in Standard Algebraic Notation ("Nbd7", "exd6", "e8=Q+",
+// "O-O") against the position. Returns MOVE_NONE unless it names exactly
+// one legal move. Only the pieces that can reach the destination are
+// examined, no move list is generated.
+Move parseSan(const Position& pos, std::string_view san);
+
+// Splits PGN text into games without copying. A game runs from its tag
+// section through its movetext up to the next tag line.
+class PgnReader {
+private:
+    const char* cursor;
+    const char* end;
+
+public:
+    PgnReader(const char* begin, const char* end) : cursor(begin), end(end) {}
+
+    // Next game, pointing into the text. Returns false when none is left.
+    bool nextGame(std::string_view& game);
+};
+
+// Replay one game: its FEN tag if any, then every move of the main line.
+// Comments, variations, NAGs and move numbers are skipped. pos ends in
+// the last position reached. Returns false at a malformed FEN, at the
+// first move that is not legal, or at an unbalanced bracket: a tag,
+// comment or variation left open, or a stray closing one.
+bool replayGame(std::string_view game, Position& pos, int& plies);
+
+struct PgnStats {
+    uint64_t games = 0;
+    uint64_t plies = 0;
+    uint64_t errors = 0; // Games stopped by an illegal or unreadable move
+};
+
+// Replay every game of a PGN text. With more than one thread the text is
+// split into shards at "[Event " lines, so no game is cut in two.
+PgnStats replayPgn(const char* data, size_t size, int threads = 1);
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "MappedFile.h"
+#include "Position.h"
+
+// Key of a position in Polyglot opening books. Polyglot hashes with its own
+// fixed table of random numbers, so this is not the same as Position::key().
+uint64_t polyglotKey(const Position& pos);
+
+struct BookMove {
+    Move move;
+    uint16_t weight;
+};
+
+// Opening book in the Polyglot .bin format: 16 byte big-endian entries
+// sorted by position key. The file is memory-mapped and binary searched in
+// place, a probe only touches the pages holding the position's entries.
+class PolyglotBook {
+private:
+    MappedFile file;
+    const unsigned char* entries = nullptr;
+    size_t entryCount = 0;
+
+    // Index of the first entry with this key, or entryCount if there is none
+    size_t findFirst(uint64_t key) const;
+
+public:
+    // Map a book file, returns false if it cannot be opened or is not a whole number of entries
+    bool open(const std::string& path);
+
+    bool isOpen() const { return file.isOpen(); }
+
+    size_t size() const { return entryCount; }
+
+    // Book moves for the position that are legal in it, at most maxMoves of
+    // them. Returns how many were written.
+    int probe(const Position& pos, BookMove* moves, int maxMoves) const;
+
+    // Book move with the highest weight, MOVE_NONE out of book
+    Move bestMove(const Position& pos) const;
+
+    // Book move drawn with a probability proportional to its weight, using
+    // the caller's random number. MOVE_NONE out of book.
+    Move weightedMove(const Position& pos, uint32_t random) const;
+};
@@ -0,0 +1,657 @@
+#include "Position.h"
+#include "MoveGen.h"
+#include "Zobrist.h"
+#include <algorithm>
+
+namespace {
+
+    // Castling rights kept when a piece leaves or arrives on each square
+    struct CastlingMask {
+        uint8_t mask[SQUARE_NB];
+
+        CastlingMask() {
+            for (uint8_t& m : mask) {
+                m = ANY_CASTLING;
+            }
+            mask[makeSquare(4, 0)] &= ~(WHITE_OO | WHITE_OOO);
+            mask[makeSquare(7, 0)] &= ~WHITE_OO;
+            mask[makeSquare(0, 0)] &= ~WHITE_OOO;
+            mask[makeSquare(4, 7)] &= ~(BLACK_OO | BLACK_OOO);
+            mask[makeSquare(7, 7)] &= ~BLACK_OO;
+            mask[makeSquare(0, 7)] &= ~BLACK_OOO;
+        }
+    };
+
+    const CastlingMask castlingMask;
+
+    const PieceType backRank[8] = { ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK };
+
+    // FEN letters, White's pieces first in PieceType order
+    const char PieceChars[] = "PNBRQKpnbrqk";
+
+    // Piece for each FEN letter, NO_PIECE for anything else
+    struct PieceLetters {
+        PieceCode piece[256];
+
+        PieceLetters() {
+            for (PieceCode& p : piece) {
+                p = NO_PIECE;
+            }
+            for (int i = 0; i < 12; ++i) {
+                piece[static_cast<unsigned char>(PieceChars[i])] = makePiece(i < 6 ? Color::WHITE : Color::BLACK, static_cast<PieceType>(i % 6));
+            }
+        }
+    };
+
+    const PieceLetters pieceLetters;
+
+    PieceCode pieceFromChar(char c) {
+        return pieceLetters.piece[static_cast<unsigned char>(c)];
+    }
+
+    bool isFenSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // Read a non-negative number at fen[i], advancing i past it
+    bool parseFenNumber(std::string_view fen, size_t& i, int& value) {
+        if (i >= fen.size() || fen[i] < '0' || fen[i] > '9') {
+            return false;
+        }
+        value = 0;
+        // Absurdly long numbers saturate instead of overflowing
+        for (; i < fen.size() && fen[i] >= '0' && fen[i] <= '9'; ++i) {
+            value = std::min(value * 10 + (fen[i] - '0'), 1000000);
+        }
+        return true;
+    }
+
+    char* writeFenNumber(char* p, int value) {
+        char digits[12];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (count) {
+            *p++ = digits[--count];
+        }
+        return p;
+    }
+}
+
+void castlingRookSquares(Square kingTo, Square& rookFrom, Square& rookTo) {
+    if (fileOf(kingTo) == 6) {
+        rookFrom = kingTo + 1;
+        rookTo = kingTo - 1;
+    }
+    else {
+        rookFrom = kingTo - 2;
+        rookTo = kingTo + 1;
+    }
+}
+
+// Constructor
+Position::Position() {
+    clear();
+}
+
+void Position::clear() {
+    for (Bitboard& b : byColor) {
+        b = 0;
+    }
+    for (Bitboard& b : byType) {
+        b = 0;
+    }
+    for (PieceCode& p : board) {
+        p = NO_PIECE;
+    }
+    side = Color::WHITE;
+    castling = NO_CASTLING;
+    epSquare = NO_SQUARE;
+    rule50 = 0;
+    fullmoves = 1;
+    stateKey = 0;
+    pawnStateKey = 0;
+    psqScore = Score();
+    phase = 0;
+    check = CheckInfo();
+}
+
+void Position::setStartPosition() {
+    clear();
+    for (int file = 0; file < 8; ++file) {
+        putPiece(makePiece(Color::WHITE, backRank[file]), makeSquare(file, 0));
+        putPiece(makePiece(Color::WHITE, PAWN), makeSquare(file, 1));
+        putPiece(makePiece(Color::BLACK, PAWN), makeSquare(file, 6));
+        putPiece(makePiece(Color::BLACK, backRank[file]), makeSquare(file, 7));
+    }
+    castling = ANY_CASTLING;
+    computeKeys();
+    computeCheckInfo();
+}
+
+void Position::computeKeys() {
+    stateKey = 0;
+    pawnStateKey = 0;
+    Bitboard occupied = pieces();
+    while (occupied) {
+        Square s = popLsb(occupied);
+        stateKey ^= Zobrist.psq[board[s]][s];
+    }
+    Bitboard pawns = pieces(PAWN);
+    while (pawns) {
+        Square s = popLsb(pawns);
+        pawnStateKey ^= Zobrist.psq[board[s]][s];
+    }
+    stateKey ^= Zobrist.castling[castling];
+    if (epSquare != NO_SQUARE) {
+        stateKey ^= Zobrist.enPassant[fileOf(epSquare)];
+    }
+    if (side == Color::BLACK) {
+        stateKey ^= Zobrist.side;
+    }
+}
+
+bool Position::setFen(std::string_view fen) {
+    size_t i = 0;
+    auto skipSpaces = [&]() {
+        while (i < fen.size() && isFenSpace(fen[i])) {
+            ++i;
+        }
+    };
+    auto fieldEnd = [&]() {
+        size_t end = i;
+        while (end < fen.size() && !isFenSpace(fen[end])) {
+            ++end;
+        }
+        return end;
+    };
+
+    clear();
+
+    // Piece placement, from rank 8 down to rank 1
+    skipSpaces();
+    int file = 0;
+    int rank = 7;
+    for (size_t end = fieldEnd(); i < end; ++i) {
+        char c = fen[i];
+        if (c == '/') {
+            file = 0;
+            --rank;
+        }
+        else if (c >= '1' && c <= '8') {
+            file += c - '0';
+        }
+        else {
+            PieceCode piece = pieceFromChar(c);
+            if (piece == NO_PIECE || file > 7 || rank < 0) {
+                return false;
+            }
+            putPiece(piece, makeSquare(file, rank));
+            ++file;
+        }
+    }
+
+    skipSpaces();
+    if (i >= fen.size() || (fen[i] != 'w' && fen[i] != 'b') || fieldEnd() != i + 1) {
+        return false;
+    }
+    side = (fen[i++] == 'w') ? Color::WHITE : Color::BLACK;
+
+    skipSpaces();
+    for (size_t end = fieldEnd(); i < end; ++i) {
+        switch (fen[i]) {
+        case 'K': castling |= WHITE_OO; break;
+        case 'Q': castling |= WHITE_OOO; break;
+        case 'k': castling |= BLACK_OO; break;
+        case 'q': castling |= BLACK_OOO; break;
+        default: break;
+        }
+    }
+
+    // Exactly one king per side, and castling only where king and rook still
+    // stand on their original squares
+    if (popcount(pieces(Color::WHITE, KING)) != 1 || popcount(pieces(Color::BLACK, KING)) != 1) {
+        return false;
+    }
+    for (Color c : { Color::WHITE, Color::BLACK }) {
+        uint8_t kingSide = (c == Color::WHITE) ? WHITE_OO : BLACK_OO;
+        uint8_t queenSide = (c == Color::WHITE) ? WHITE_OOO : BLACK_OOO;
+        if (board[relativeSquare(c, makeSquare(4, 0))] != makePiece(c, KING)) {
+            castling &= ~(kingSide | queenSide);
+        }
+        if (board[relativeSquare(c, makeSquare(7, 0))] != makePiece(c, ROOK)) {
+            castling &= ~kingSide;
+        }
+        if (board[relativeSquare(c, makeSquare(0, 0))] != makePiece(c, ROOK)) {
+            castling &= ~queenSide;
+        }
+    }
+
+    // Keep the en passant square only if an enemy pawn can just have made a
+    // double push past it, and a pawn of the side to move can capture there
+    skipSpaces();
+    size_t epEnd = fieldEnd();
+    if (epEnd == i + 2 && fen[i] >= 'a' && fen[i] <= 'h' && fen[i + 1] == (side == Color::WHITE ? '6' : '3')) {
+        Square ep = makeSquare(fen[i] - 'a', fen[i + 1] - '1');
+        if (empty(ep) && empty(ep + pawnPush(side))
+            && board[ep - pawnPush(side)] == makePiece(~side, PAWN)
+            && (pawnAttacks(~side, ep) & pieces(side, PAWN))) {
+            epSquare = ep;
+        }
+    }
+    i = epEnd;
+
+    // Move clocks are optional, EPD lines carry operations there instead
+    skipSpaces();
+    int halfmoves, moveNumber;
+    if (parseFenNumber(fen, i, halfmoves) && (skipSpaces(), parseFenNumber(fen, i, moveNumber))) {
+        rule50 = halfmoves;
+        fullmoves = std::max(moveNumber, 1);
+    }
+    computeKeys();
+    computeCheckInfo();
+    return true;
+}
+
+size_t Position::toFen(char* out) const {
+    char* p = out;
+    for (int rank = 7; rank >= 0; --rank) {
+        int emptyCount = 0;
+        for (int file = 0; file < 8; ++file) {
+            PieceCode piece = board[makeSquare(file, rank)];
+            if (piece == NO_PIECE) {
+                ++emptyCount;
+                continue;
+            }
+            if (emptyCount) {
+                *p++ = static_cast<char>('0' + emptyCount);
+                emptyCount = 0;
+            }
+            *p++ = PieceChars[colorIndex(colorOf(piece)) * 6 + typeOf(piece)];
+        }
+        if (emptyCount) {
+            *p++ = static_cast<char>('0' + emptyCount);
+        }
+        if (rank) {
+            *p++ = '/';
+        }
+    }
+
+    *p++ = ' ';
+    *p++ = (side == Color::WHITE) ? 'w' : 'b';
+
+    *p++ = ' ';
+    if (castling == NO_CASTLING) {
+        *p++ = '-';
+    }
+    if (castling & WHITE_OO) *p++ = 'K';
+    if (castling & WHITE_OOO) *p++ = 'Q';
+    if (castling & BLACK_OO) *p++ = 'k';
+    if (castling & BLACK_OOO) *p++ = 'q';
+
+    *p++ = ' ';
+    if (epSquare == NO_SQUARE) {
+        *p++ = '-';
+    }
+    else {
+        *p++ = static_cast<char>('a' + fileOf(epSquare));
+        *p++ = static_cast<char>('1' + rankOf(epSquare));
+    }
+
+    *p++ = ' ';
+    p = writeFenNumber(p, rule50);
+    *p++ = ' ';
+    p = writeFenNumber(p, fullmoves);
+    *p = '\0';
+    return static_cast<size_t>(p - out);
+}
+
+std::string Position::fen() const {
+    char buffer[MAX_FEN_LENGTH];
+    return std::string(buffer, toFen(buffer));
+}
+
+void Position::putPiece(PieceCode piece, Square s) {
+    board[s] = piece;
+    byColor[colorIndex(colorOf(piece))] |= squareBB(s);
+    byType[typeOf(piece)] |= squareBB(s);
+    psqScore += Psqt.psq[piece][s];
+    phase += PhaseWeight[typeOf(piece)];
+}
+
+void Position::removePiece(Square s) {
+    PieceCode piece = board[s];
+    if (piece == NO_PIECE) {
+        return;
+    }
+    byColor[colorIndex(colorOf(piece))] ^= squareBB(s);
+    byType[typeOf(piece)] ^= squareBB(s);
+    board[s] = NO_PIECE;
+    psqScore -= Psqt.psq[piece][s];
+    phase -= PhaseWeight[typeOf(piece)];
+}
+
+void Position::movePiece(Square from, Square to) {
+    PieceCode piece = board[from];
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+    byColor[colorIndex(colorOf(piece))] ^= fromTo;
+    byType[typeOf(piece)] ^= fromTo;
+    board[from] = NO_PIECE;
+    board[to] = piece;
+    psqScore += Psqt.psq[piece][to] - Psqt.psq[piece][from];
+}
+
+Square Position::kingSquare(Color c) const {
+    Bitboard king = pieces(c, KING);
+    return king ? lsb(king) : NO_SQUARE;
+}
+
+Bitboard Position::attackersTo(Square s, Bitboard occupied) const {
+    return (pawnAttacks(Color::BLACK, s) & pieces(Color::WHITE, PAWN))
+        | (pawnAttacks(Color::WHITE, s) & pieces(Color::BLACK, PAWN))
+        | (KnightAttacks[s] & pieces(KNIGHT))
+        | (bishopAttacks(s, occupied) & (pieces(BISHOP) | pieces(QUEEN)))
+        | (rookAttacks(s, occupied) & (pieces(ROOK) | pieces(QUEEN)))
+        | (KingAttacks[s] & pieces(KING));
+}
+
+bool Position::isSquareAttacked(Square s, Color by) const {
+    return attackersTo(s, pieces()) & pieces(by);
+}
+
+Bitboard Position::sliderBlockers(Color c) const {
+    Square king = kingSquare(c);
+    if (king == NO_SQUARE) {
+        return 0;
+    }
+
+    // Enemy sliders lined up with the king on an empty board, each is
+    // blocked by exactly one piece if that piece is pinned or discovering
+    Bitboard snipers = ((rookAttacks(king, 0) & (pieces(ROOK) | pieces(QUEEN)))
+        | (bishopAttacks(king, 0) & (pieces(BISHOP) | pieces(QUEEN)))) & pieces(~c);
+    Bitboard occupied = pieces() ^ snipers;
+    Bitboard blockers = 0;
+    while (snipers) {
+        Bitboard between = betweenBB(king, popLsb(snipers)) & occupied;
+        if (between && !moreThanOne(between)) {
+            blockers |= between;
+        }
+    }
+    return blockers;
+}
+
+void Position::computeCheckInfo() {
+    Square king = kingSquare(side);
+    check.checkers = (king != NO_SQUARE) ? attackersTo(king, pieces()) & pieces(~side) : 0;
+    check.blockers[0] = sliderBlockers(Color::WHITE);
+    check.blockers[1] = sliderBlockers(Color::BLACK);
+
+    // A piece gives check from the squares it would attack the enemy king from
+    Square theirKing = kingSquare(~side);
+    if (theirKing == NO_SQUARE) {
+        for (Bitboard& b : check.checkSquares) {
+            b = 0;
+        }
+        return;
+    }
+    Bitboard occupied = pieces();
+    check.checkSquares[PAWN] = pawnAttacks(~side, theirKing);
+    check.checkSquares[KNIGHT] = KnightAttacks[theirKing];
+    check.checkSquares[BISHOP] = bishopAttacks(theirKing, occupied);
+    check.checkSquares[ROOK] = rookAttacks(theirKing, occupied);
+    check.checkSquares[QUEEN] = check.checkSquares[BISHOP] | check.checkSquares[ROOK];
+    check.checkSquares[KING] = 0;
+}
+
+bool Position::givesCheck(Move m) const {
+    Color us = side;
+    Square from = fromSq(m);
+    Square to = toSq(m);
+    MoveType type = typeOfMove(m);
+    PieceType pt = typeOf(board[from]);
+    Square theirKing = kingSquare(~us);
+    if (theirKing == NO_SQUARE) {
+        return false;
+    }
+
+    // Direct check by the moving piece
+    if (type != PROMOTION && (check.checkSquares[pt] & squareBB(to))) {
+        return true;
+    }
+
+    // Discovered check: a slider behind the moved piece now sees the king
+    Bitboard occupied = (pieces() ^ squareBB(from)) | squareBB(to);
+    if (check.blockers[colorIndex(~us)] & squareBB(from)) {
+        Bitboard sliders = ((rookAttacks(theirKing, occupied) & (pieces(us, ROOK) | pieces(us, QUEEN)))
+            | (bishopAttacks(theirKing, occupied) & (pieces(us, BISHOP) | pieces(us, QUEEN))))
+            & ~squareBB(from);
+        if (sliders) {
+            return true;
+        }
+    }
+
+    switch (type) {
+    case PROMOTION:
+        return attacks(promotionType(m), to, pieces() ^ squareBB(from)) & squareBB(theirKing);
+
+    case EN_PASSANT: {
+        // The captured pawn may have been the last piece shielding the king
+        occupied ^= squareBB(to - pawnPush(us));
+        return ((rookAttacks(theirKing, occupied) & (pieces(us, ROOK) | pieces(us, QUEEN)))
+            | (bishopAttacks(theirKing, occupied) & (pieces(us, BISHOP) | pieces(us, QUEEN))));
+    }
+
+    case CASTLING: {
+        Square rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        occupied = (pieces() ^ squareBB(from) ^ squareBB(rookFrom)) | squareBB(to) | squareBB(rookTo);
+        return rookAttacks(rookTo, occupied) & squareBB(theirKing);
+    }
+
+    default:
+        return false;
+    }
+}
+
+Move Position::findMove(Square from, Square to, PieceType promotion) const {
+    MoveList moves;
+    generate<PSEUDO_LEGAL>(*this, moves);
+    for (Move m : moves) {
+        if (fromSq(m) == from && toSq(m) == to
+            && (typeOfMove(m) != PROMOTION || promotionType(m) == promotion)) {
+            return m;
+        }
+    }
+    return MOVE_NONE;
+}
+
+bool Position::isLegal(Move m) const {
+    Color us = side;
+    Square from = fromSq(m);
+    Square to = toSq(m);
+    Square king = kingSquare(us);
+    if (king == NO_SQUARE) {
+        return true;
+    }
+
+    // En passant removes two pieces from the board, test the king directly
+    if (typeOfMove(m) == EN_PASSANT) {
+        Square captureSquare = to - pawnPush(us);
+        Bitboard occupied = (pieces() ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(to);
+        return !(attackersTo(king, occupied) & pieces(~us) & ~squareBB(captureSquare));
+    }
+
+    // The castling path was checked by the generator, only the landing square is left
+    if (typeOfMove(m) == CASTLING) {
+        return !inCheck() && !isSquareAttacked(to, ~us);
+    }
+
+    // The king may not step onto an attacked square, including squares
+    // behind it on the line of a checking slider
+    if (from == king) {
+        return !(attackersTo(to, pieces() ^ squareBB(king)) & pieces(~us));
+    }
+
+    // In check another piece must capture the checker or block its line
+    Bitboard checkers = check.checkers;
+    if (checkers) {
+        if (moreThanOne(checkers) || !((betweenBB(king, lsb(checkers)) | checkers) & squareBB(to))) {
+            return false;
+        }
+    }
+
+    // A pinned piece may only move along the pin
+    return !(pinned(us) & squareBB(from)) || (lineBB(from, king) & squareBB(to));
+}
+
+void Position::doMove(Move m, UndoInfo& undo) {
+    Color us = side;
+    Square from = fromSq(m);
+    Square to = toSq(m);
+    MoveType type = typeOfMove(m);
+    PieceCode piece = board[from];
+
+    undo.castling = castling;
+    undo.epSquare = static_cast<uint8_t>(epSquare);
+    undo.rule50 = static_cast<uint16_t>(rule50);
+    undo.key = stateKey;
+    undo.pawnKey = pawnStateKey;
+    undo.checkInfo = check;
+
+    // Keys are updated with the change only, never recomputed
+    uint64_t key = stateKey ^ Zobrist.side;
+
+    ++rule50;
+    if (us == Color::BLACK) {
+        ++fullmoves;
+    }
+
+    // Remove the captured piece, which for en passant is behind the destination
+    Square captureSquare = (type == EN_PASSANT) ? to - pawnPush(us) : to;
+    undo.captured = board[captureSquare];
+    if (undo.captured != NO_PIECE) {
+        key ^= Zobrist.psq[undo.captured][captureSquare];
+        if (typeOf(undo.captured) == PAWN) {
+            pawnStateKey ^= Zobrist.psq[undo.captured][captureSquare];
+        }
+        removePiece(captureSquare);
+        rule50 = 0;
+    }
+
+    if (type == CASTLING) {
+        Square rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        key ^= Zobrist.psq[board[rookFrom]][rookFrom] ^ Zobrist.psq[board[rookFrom]][rookTo];
+        movePiece(rookFrom, rookTo);
+    }
+
+    key ^= Zobrist.psq[piece][from] ^ Zobrist.psq[piece][to];
+    movePiece(from, to);
+
+    if (epSquare != NO_SQUARE) {
+        key ^= Zobrist.enPassant[fileOf(epSquare)];
+        epSquare = NO_SQUARE;
+    }
+
+    if (typeOf(piece) == PAWN) {
+        rule50 = 0;
+        pawnStateKey ^= Zobrist.psq[piece][from] ^ Zobrist.psq[piece][to];
+
+        // Only record the en passant square when an enemy pawn can use it,
+        // so positions differing in nothing else share a key
+        if ((from ^ to) == 16 && (pawnAttacks(us, (from + to) / 2) & pieces(~us, PAWN))) {
+            epSquare = (from + to) / 2;
+            key ^= Zobrist.enPassant[fileOf(epSquare)];
+        }
+
+        if (type == PROMOTION) {
+            PieceCode promoted = makePiece(us, promotionType(m));
+            key ^= Zobrist.psq[piece][to] ^ Zobrist.psq[promoted][to];
+            pawnStateKey ^= Zobrist.psq[piece][to];
+            removePiece(to);
+            putPiece(promoted, to);
+        }
+    }
+
+    uint8_t newCastling = castling & castlingMask.mask[from] & castlingMask.mask[to];
+    key ^= Zobrist.castling[castling] ^ Zobrist.castling[newCastling];
+    castling = newCastling;
+
+    stateKey = key;
+    side = ~us;
+    computeCheckInfo();
+}
+
+uint64_t Position::keyAfter(Move m) const {
+    Square from = fromSq(m);
+    Square to = toSq(m);
+    PieceCode piece = board[from];
+    uint64_t key = stateKey ^ Zobrist.side ^ Zobrist.psq[piece][from] ^ Zobrist.psq[piece][to];
+    if (board[to] != NO_PIECE) {
+        key ^= Zobrist.psq[board[to]][to];
+    }
+    return key;
+}
+
+void Position::doMove(Move m) {
+    UndoInfo undo;
+    doMove(m, undo);
+}
+
+void Position::undoMove(Move m, const UndoInfo& undo) {
+    side = ~side;
+    Color us = side;
+    Square from = fromSq(m);
+    Square to = toSq(m);
+    MoveType type = typeOfMove(m);
+
+    if (type == PROMOTION) {
+        removePiece(to);
+        putPiece(makePiece(us, PAWN), to);
+    }
+
+    movePiece(to, from);
+
+    if (type == CASTLING) {
+        Square rookFrom, rookTo;
+        castlingRookSquares(to, rookFrom, rookTo);
+        movePiece(rookTo, rookFrom);
+    }
+
+    if (undo.captured != NO_PIECE) {
+        putPiece(undo.captured, (type == EN_PASSANT) ? to - pawnPush(us) : to);
+    }
+
+    castling = undo.castling;
+    epSquare = undo.epSquare;
+    rule50 = undo.rule50;
+    stateKey = undo.key;
+    pawnStateKey = undo.pawnKey;
+    check = undo.checkInfo;
+    if (us == Color::BLACK) {
+        --fullmoves;
+    }
+}
+
+bool Position::hasLegalMoves() const {
+    MoveList moves;
+    generate<LEGAL>(*this, moves);
+    return !moves.empty();
+}
+
+GameStatus Position::status() const {
+    if (!hasLegalMoves()) {
+        return inCheck() ? GameStatus::CHECKMATE : GameStatus::STALEMATE;
+    }
+    if (rule50 >= 100) {
+        return GameStatus::DRAW_FIFTY_MOVES;
+    }
+
+    // Bare kings, or a single minor piece against a bare king
+    if (!pieces(PAWN) && !pieces(ROOK) && !pieces(QUEEN) && popcount(pieces(KNIGHT) | pieces(BISHOP)) <= 1) {
+        return GameStatus::DRAW_INSUFFICIENT_MATERIAL;
+    }
+    return GameStatus::ONGOING;
+}
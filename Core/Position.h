@@ -0,0 +1,182 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include "Bitboard.h"
+#include "Move.h"
+#include "Psqt.h"
+
+constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Buffer size always enough for toFen, terminating zero included
+constexpr size_t MAX_FEN_LENGTH = 128;
+
+// Check related bitboards, computed once per position when it is set up or a
+// move is made, so check tests during search are plain lookups
+struct CheckInfo {
+    Bitboard checkers;                    // Enemy pieces giving check to the side to move
+    Bitboard blockers[COLOR_NB];          // Pieces of either color shielding the king of each color from a slider
+    Bitboard checkSquares[PIECE_TYPE_NB]; // Squares where a piece of the side to move would give check
+};
+
+// Everything doMove overwrites that undoMove cannot work out from the move itself.
+// Callers keep one per ply, typically in an array on the stack.
+struct UndoInfo {
+    PieceCode captured; // Piece taken by the move, or NO_PIECE
+    uint8_t castling;   // Castling rights before the move
+    uint8_t epSquare;   // En passant square before the move
+    uint16_t rule50;    // Half move clock before the move
+    uint64_t key;       // Position keys before the move
+    uint64_t pawnKey;
+    CheckInfo checkInfo; // Check bitboards before the move
+};
+
+// Game state independent of any rendering: piece placement stored as
+// bitboards per color and per piece kind with an 8x8 mailbox for constant
+// time square lookup, plus side to move, castling rights, en passant square
+// and move clocks. This is all the rules need to validate and apply moves.
+class Position {
+private:
+    Bitboard byColor[COLOR_NB];    // All pieces of each color
+    Bitboard byType[PIECE_TYPE_NB]; // All pieces of each kind, both colors
+    PieceCode board[SQUARE_NB];    // Piece standing on each square, or NO_PIECE
+    Color side;                    // Side to move
+    uint8_t castling;              // CastlingRights still available
+    Square epSquare;               // Square a pawn may capture en passant onto, or NO_SQUARE
+    int rule50;                    // Half moves since the last capture or pawn move
+    int fullmoves;                 // Move number, starting at 1 and increased after Black moves
+    uint64_t stateKey;             // Zobrist key of the whole position
+    uint64_t pawnStateKey;         // Zobrist key of the pawns only
+    Score psqScore;                // Sum of the piece-square scores of all pieces
+    int phase;                     // Sum of PhaseWeight of all pieces
+    CheckInfo check;               // Checkers, blockers and checking squares
+
+    // Pieces shielding the king of color c from enemy sliders
+    Bitboard sliderBlockers(Color c) const;
+
+public:
+    // Constructor creates an empty board with White to move
+    Position();
+
+    // Remove every piece from the board and reset the game state
+    void clear();
+
+    // Set up the standard initial position
+    void setStartPosition();
+
+    // Set up the position described by a FEN string, returns false if it is
+    // malformed or a side does not have exactly one king. Castling rights the
+    // king and rook placement cannot support are dropped. Parses in place
+    // without allocating. Move clocks may be missing, so EPD lines are
+    // accepted too.
+    bool setFen(std::string_view fen);
+
+    // Write the FEN of the position into out, which must hold MAX_FEN_LENGTH
+    // chars. Returns the length, not counting the terminating zero.
+    size_t toFen(char* out) const;
+
+    std::string fen() const;
+
+    void putPiece(PieceCode piece, Square s);
+
+    void removePiece(Square s);
+
+    void movePiece(Square from, Square to);
+
+    // Change the side to move after placing pieces by hand, before
+    // computeKeys and computeCheckInfo
+    void setSideToMove(Color c) { side = c; }
+
+    // Recompute the keys from scratch after placing pieces by hand
+    void computeKeys();
+
+    // Recompute the check bitboards after placing pieces by hand
+    void computeCheckInfo();
+
+    PieceCode pieceOn(Square s) const { return board[s]; }
+
+    bool empty(Square s) const { return board[s] == NO_PIECE; }
+
+    Bitboard pieces() const { return byColor[0] | byColor[1]; }
+
+    Bitboard pieces(Color c) const { return byColor[colorIndex(c)]; }
+
+    Bitboard pieces(PieceType pt) const { return byType[pt]; }
+
+    Bitboard pieces(Color c, PieceType pt) const { return byColor[colorIndex(c)] & byType[pt]; }
+
+    // Square of the king of the given color, or NO_SQUARE if there is none
+    Square kingSquare(Color c) const;
+
+    Color sideToMove() const { return side; }
+
+    uint8_t castlingRights() const { return castling; }
+
+    Square enPassantSquare() const { return epSquare; }
+
+    int halfmoveClock() const { return rule50; }
+
+    int fullmoveNumber() const { return fullmoves; }
+
+    // Zobrist key of placement, side to move, castling rights and en passant file
+    uint64_t key() const { return stateKey; }
+
+    // Zobrist key of the pawns of both colors
+    uint64_t pawnKey() const { return pawnStateKey; }
+
+    // Material and piece-square score, kept up to date by every piece change
+    Score psq() const { return psqScore; }
+
+    // Game phase, PHASE_MAX in the opening and falling as pieces are traded.
+    // Promotions can push it above PHASE_MAX.
+    int gamePhase() const { return phase; }
+
+    // Key after the move, ignoring castling and en passant changes.
+    // Cheap enough to prefetch the table entry before making the move.
+    uint64_t keyAfter(Move m) const;
+
+    // All pieces of both colors attacking square s with the given occupancy
+    Bitboard attackersTo(Square s, Bitboard occupied) const;
+
+    bool isSquareAttacked(Square s, Color by) const;
+
+    // Whether the side to move is in check
+    bool inCheck() const { return check.checkers; }
+
+    // Enemy pieces giving check to the side to move
+    Bitboard checkers() const { return check.checkers; }
+
+    // Pieces of color c that are pinned to their own king
+    Bitboard pinned(Color c) const { return check.blockers[colorIndex(c)] & pieces(c); }
+
+    // Pieces of either color whose move may expose the king of color c
+    Bitboard blockersForKing(Color c) const { return check.blockers[colorIndex(c)]; }
+
+    // Whether a pseudo-legal move of the side to move checks the enemy king
+    bool givesCheck(Move m) const;
+
+    // Find the pseudo-legal move of the piece on 'from' to 'to', or MOVE_NONE.
+    // Pawns reaching the last rank promote to 'promotion'.
+    Move findMove(Square from, Square to, PieceType promotion = QUEEN) const;
+
+    bool isCapture(Move m) const { return !empty(toSq(m)) || typeOfMove(m) == EN_PASSANT; }
+
+    // Whether a pseudo-legal move leaves the own king safe. Decided from the
+    // check and pin bitboards, the move is never made.
+    bool isLegal(Move m) const;
+
+    // Apply a legal move in place, saving what is needed to take it back in undo
+    void doMove(Move m, UndoInfo& undo);
+
+    // Apply a legal move that will not be taken back
+    void doMove(Move m);
+
+    // Take back the last move made with doMove(m, undo)
+    void undoMove(Move m, const UndoInfo& undo);
+
+    bool hasLegalMoves() const;
+
+    GameStatus status() const;
+};
+
+// Rook origin and destination for a castling move landing the king on kingTo
+void castlingRookSquares(Square kingTo, Square& rookFrom, Square& rookTo);
@@ -0,0 +1,560 @@
+#include "Search.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "Evaluate.h"
+#include "MoveGen.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    int64_t elapsedMs(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    }
+
+    // Mate scores are stored relative to the node instead of the root,
+    // so they stay correct when the position is reached at another ply
+    int scoreToTT(int score, int ply) {
+        if (score >= VALUE_MATE_IN_MAX_PLY) {
+            return score + ply;
+        }
+        if (score <= -VALUE_MATE_IN_MAX_PLY) {
+            return score - ply;
+        }
+        return score;
+    }
+
+    int scoreFromTT(int score, int ply) {
+        if (score >= VALUE_MATE_IN_MAX_PLY) {
+            return score - ply;
+        }
+        if (score <= -VALUE_MATE_IN_MAX_PLY) {
+            return score + ply;
+        }
+        return score;
+    }
+
+    // Half width of the first aspiration window around the previous score
+    constexpr int ASPIRATION_WINDOW = 25;
+
+    // Move ordering scores: hash move, then captures by victim and attacker,
+    // then killers, then quiet moves by history
+    constexpr int ORDER_TT_MOVE = 1 << 30;
+    constexpr int ORDER_CAPTURE = 1 << 28;
+    constexpr int ORDER_KILLER = 1 << 27;
+
+    // Depth skipping of helper threads in Lazy SMP. Helper i searches a
+    // depth only if ((depth + SkipPhase[i]) / SkipSize[i]) is even, so
+    // helpers spread over different depths instead of duplicating work.
+    constexpr int SKIP_COUNT = 20;
+    constexpr int SkipSize[SKIP_COUNT] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    constexpr int SkipPhase[SKIP_COUNT] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+}
+
+// State common to all threads of one search
+struct SearchShared {
+    TranspositionTable& tt;
+    std::atomic<bool>& stop;
+    SearchLimits limits;
+    Clock::time_point startTime;
+    std::atomic<uint64_t> nodes{ 0 }; // All threads, updated every 1024 nodes
+};
+
+// State of one search thread: its own copy of the position, undo stack,
+// ordering heuristics, principal variation and counters. Thread 0 is the
+// main thread, it alone checks the limits and reports progress.
+class SearchWorker {
+public:
+    SearchWorker(int id, SearchShared& shared) : id(id), shared(shared), tt(shared.tt), limits(shared.limits) {}
+
+    void setPosition(const Position& rootPosition, const std::vector<uint64_t>& history);
+
+    // Iterative deepening from depth 1 up to the depth limit
+    SearchResult iterate(const InfoCallback& onInfo);
+
+    uint64_t nodeCount() const { return nodes; }
+
+    const TTStats& tableStats() const { return ttStats; }
+
+private:
+    int search(int alpha, int beta, int depth, int ply);
+
+    int qsearch(int alpha, int beta, int ply);
+
+    bool isDraw() const;
+
+    void checkLimits();
+
+    // Order moves into 'ordered' by descending score
+    int orderMoves(const MoveList& moves, Move ordered[], Move ttMove, int ply) const;
+
+    void updatePv(Move m, int ply);
+
+    int id;
+    SearchShared& shared;
+    TranspositionTable& tt;
+    const SearchLimits& limits;
+
+    Position pos;
+    std::vector<uint64_t> keys;          // Keys of the game and search path, current position last
+    UndoInfo undo[MAX_PLY];
+    Move killers[MAX_PLY][2] = {};
+    int history[COLOR_NB][SQUARE_NB][SQUARE_NB] = {};
+    Move pvTable[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY] = {};
+
+    uint64_t nodes = 0;
+    uint64_t reportedNodes = 0;          // Part of nodes already added to shared.nodes
+    TTStats ttStats;
+    bool canAbort = false;               // Set once the first iteration has completed
+    bool aborted = false;
+};
+
+void SearchWorker::setPosition(const Position& rootPosition, const std::vector<uint64_t>& gameKeys) {
+    pos = rootPosition;
+    keys.reserve(gameKeys.size() + MAX_PLY + 1);
+    keys = gameKeys;
+    keys.push_back(pos.key());
+}
+
+void SearchWorker::checkLimits() {
+    shared.nodes.fetch_add(nodes - reportedNodes, std::memory_order_relaxed);
+    reportedNodes = nodes;
+
+    // Helpers run until the main thread is done
+    if (id != 0) {
+        aborted = shared.stop.load(std::memory_order_relaxed);
+        return;
+    }
+    if (!canAbort) {
+        return;
+    }
+    if (shared.stop.load(std::memory_order_relaxed)
+        || (limits.nodes && shared.nodes.load(std::memory_order_relaxed) >= limits.nodes)
+        || (limits.movetime && elapsedMs(shared.startTime) >= limits.movetime)) {
+        aborted = true;
+    }
+}
+
+bool SearchWorker::isDraw() const {
+    if (pos.halfmoveClock() >= 100) {
+        return true;
+    }
+
+    // A position seen before since the last irreversible move. One
+    // repetition is enough inside the search: the side ahead would avoid it.
+    uint64_t current = keys.back();
+    int last = static_cast<int>(keys.size()) - 1;
+    int limit = std::max(0, last - pos.halfmoveClock());
+    for (int i = last - 4; i >= limit; i -= 2) {
+        if (keys[i] == current) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int SearchWorker::orderMoves(const MoveList& moves, Move ordered[], Move ttMove, int ply) const {
+    int scores[MAX_MOVES];
+    int count = 0;
+    Color us = pos.sideToMove();
+
+    for (Move m : moves) {
+        int score;
+        if (m == ttMove) {
+            score = ORDER_TT_MOVE;
+        }
+        else if (pos.isCapture(m) || typeOfMove(m) == PROMOTION) {
+            // Most valuable victim, least valuable attacker
+            PieceType victim = (typeOfMove(m) == EN_PASSANT) ? PAWN : typeOf(pos.pieceOn(toSq(m)));
+            int victimValue = (victim == NO_PIECE_TYPE) ? 0 : 10 * (victim + 1);
+            int promotionValue = (typeOfMove(m) == PROMOTION) ? 10 * promotionType(m) : 0;
+            score = ORDER_CAPTURE + victimValue + promotionValue - typeOf(pos.pieceOn(fromSq(m)));
+        }
+        else if (m == killers[ply][0] || m == killers[ply][1]) {
+            score = ORDER_KILLER + (m == killers[ply][0] ? 1 : 0);
+        }
+        else {
+            score = history[colorIndex(us)][fromSq(m)][toSq(m)];
+        }
+
+        // Insertion sort, move lists are short
+        int i = count++;
+        while (i > 0 && scores[i - 1] < score) {
+            scores[i] = scores[i - 1];
+            ordered[i] = ordered[i - 1];
+            --i;
+        }
+        scores[i] = score;
+        ordered[i] = m;
+    }
+    return count;
+}
+
+void SearchWorker::updatePv(Move m, int ply) {
+    pvTable[ply][ply] = m;
+    for (int i = ply + 1; i < pvLength[ply + 1]; ++i) {
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    }
+    pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+}
+
+int SearchWorker::search(int alpha, int beta, int depth, int ply) {
+    pvLength[ply] = ply;
+    if (depth <= 0) {
+        return qsearch(alpha, beta, ply);
+    }
+
+    if ((++nodes & 1023) == 0) {
+        checkLimits();
+    }
+    if (aborted) {
+        return 0;
+    }
+
+    bool pvNode = beta - alpha > 1;
+    if (ply > 0) {
+        if (isDraw()) {
+            return VALUE_DRAW;
+        }
+        if (ply >= MAX_PLY - 1) {
+            return evaluate(pos);
+        }
+
+        // Mate distance pruning: no score can beat a mate found closer to the root
+        alpha = std::max(alpha, -VALUE_MATE + ply);
+        beta = std::min(beta, VALUE_MATE - ply - 1);
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+
+    TTData ttData;
+    Move ttMove = MOVE_NONE;
+    if (tt.probe(pos.key(), ttData, ttStats)) {
+        ttMove = ttData.move;
+        int ttScore = scoreFromTT(ttData.score, ply);
+        if (!pvNode && ttData.depth >= depth
+            && (ttData.bound & (ttScore >= beta ? BOUND_LOWER : BOUND_UPPER))) {
+            return ttScore;
+        }
+    }
+
+    bool inCheck = pos.inCheck();
+    MoveList moves;
+    generate<LEGAL>(pos, moves);
+    if (moves.empty()) {
+        return inCheck ? -VALUE_MATE + ply : VALUE_DRAW;
+    }
+
+    // Check extension
+    if (inCheck) {
+        ++depth;
+    }
+
+    Move ordered[MAX_MOVES];
+    int count = orderMoves(moves, ordered, ttMove, ply);
+
+    int originalAlpha = alpha;
+    int bestScore = -VALUE_INFINITE;
+    Move bestMove = MOVE_NONE;
+
+    for (int i = 0; i < count; ++i) {
+        Move m = ordered[i];
+        tt.prefetch(pos.keyAfter(m));
+        pos.doMove(m, undo[ply]);
+        keys.push_back(pos.key());
+
+        // Principal variation search: full window for the first move, null
+        // window for the rest, re-searched only if they turn out better
+        int score;
+        if (i == 0) {
+            score = -search(-beta, -alpha, depth - 1, ply + 1);
+        }
+        else {
+            score = -search(-alpha - 1, -alpha, depth - 1, ply + 1);
+            if (score > alpha && score < beta) {
+                score = -search(-beta, -alpha, depth - 1, ply + 1);
+            }
+        }
+
+        keys.pop_back();
+        pos.undoMove(m, undo[ply]);
+
+        if (aborted) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = m;
+            if (score > alpha) {
+                alpha = score;
+                updatePv(m, ply);
+                if (alpha >= beta) {
+                    // Remember quiet moves causing a cutoff for ordering elsewhere
+                    if (!pos.isCapture(m) && typeOfMove(m) != PROMOTION) {
+                        if (killers[ply][0] != m) {
+                            killers[ply][1] = killers[ply][0];
+                            killers[ply][0] = m;
+                        }
+                        int& h = history[colorIndex(pos.sideToMove())][fromSq(m)][toSq(m)];
+                        h = std::min(h + depth * depth, ORDER_KILLER - 1);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    Bound bound = (bestScore >= beta) ? BOUND_LOWER : (alpha > originalAlpha) ? BOUND_EXACT : BOUND_UPPER;
+    tt.store(pos.key(), bestMove, scoreToTT(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+int SearchWorker::qsearch(int alpha, int beta, int ply) {
+    pvLength[ply] = ply;
+
+    if ((++nodes & 1023) == 0) {
+        checkLimits();
+    }
+    if (aborted) {
+        return 0;
+    }
+    if (ply >= MAX_PLY - 1) {
+        return evaluate(pos);
+    }
+
+    // In check every evasion is tried, otherwise the side to move may
+    // stand pat on the static evaluation and only look at captures
+    bool inCheck = pos.inCheck();
+    int bestScore = -VALUE_INFINITE;
+    MoveList moves;
+    if (inCheck) {
+        generate<LEGAL>(pos, moves);
+        if (moves.empty()) {
+            return -VALUE_MATE + ply;
+        }
+    }
+    else {
+        bestScore = evaluate(pos);
+        if (bestScore >= beta) {
+            return bestScore;
+        }
+        alpha = std::max(alpha, bestScore);
+        generate<CAPTURES>(pos, moves);
+    }
+
+    Move ordered[MAX_MOVES];
+    int count = orderMoves(moves, ordered, MOVE_NONE, ply);
+
+    for (int i = 0; i < count; ++i) {
+        Move m = ordered[i];
+        if (!inCheck && !pos.isLegal(m)) {
+            continue;
+        }
+
+        pos.doMove(m, undo[ply]);
+        keys.push_back(pos.key());
+        int score = -qsearch(-beta, -alpha, ply + 1);
+        keys.pop_back();
+        pos.undoMove(m, undo[ply]);
+
+        if (aborted) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+    return bestScore;
+}
+
+SearchResult SearchWorker::iterate(const InfoCallback& onInfo) {
+    SearchResult result;
+
+    MoveList rootMoves;
+    generate<LEGAL>(pos, rootMoves);
+    if (rootMoves.empty()) {
+        result.score = pos.inCheck() ? -VALUE_MATE : VALUE_DRAW;
+        return result;
+    }
+    result.bestMove = rootMoves[0];
+    result.pv = { rootMoves[0] };
+
+    int score = 0;
+    for (int depth = 1; depth <= limits.depth && depth < MAX_PLY; ++depth) {
+        if (id > 0) {
+            int i = (id - 1) % SKIP_COUNT;
+            if (((depth + SkipPhase[i]) / SkipSize[i]) % 2 != 0) {
+                continue;
+            }
+        }
+
+        // Aspiration window around the previous score, widened on failure
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -VALUE_INFINITE;
+        int beta = VALUE_INFINITE;
+        if (depth >= 5 && !isMateScore(score)) {
+            alpha = std::max(score - delta, -VALUE_INFINITE);
+            beta = std::min(score + delta, VALUE_INFINITE);
+        }
+
+        while (true) {
+            score = search(alpha, beta, depth, 0);
+            if (aborted) {
+                break;
+            }
+            if (score <= alpha) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(score - delta, -VALUE_INFINITE);
+            }
+            else if (score >= beta) {
+                beta = std::min(score + delta, VALUE_INFINITE);
+            }
+            else {
+                break;
+            }
+            delta *= 2;
+        }
+
+        // An unfinished iteration is discarded
+        if (aborted) {
+            break;
+        }
+        canAbort = true;
+
+        result.bestMove = pvTable[0][0];
+        result.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+        result.score = score;
+        result.depth = depth;
+        if (onInfo) {
+            // Node counts of the other threads are at most 1024 behind
+            checkLimits();
+            result.nodes = shared.nodes.load(std::memory_order_relaxed);
+            result.timeMs = elapsedMs(shared.startTime);
+            result.nps = result.nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(result.timeMs, 1));
+            result.hashfull = tt.hashfull();
+            result.ttHitRate = ttStats.hitRate();
+            onInfo(result);
+        }
+
+        // A mate found within the searched depth cannot get any shorter
+        if (isMateScore(score) && VALUE_MATE - std::abs(score) <= depth) {
+            break;
+        }
+        checkLimits();
+        if (aborted) {
+            break;
+        }
+    }
+    return result;
+}
+
+// Constructor
+Engine::Engine() {
+    tt.resize(16);
+}
+
+Engine::~Engine() {
+    stop();
+    wait();
+}
+
+void Engine::setHashSize(size_t megabytes) {
+    tt.resize(megabytes);
+}
+
+void Engine::clearHash() {
+    tt.clear(threadCount);
+}
+
+void Engine::setThreads(int threads) {
+    threadCount = std::max(1, threads);
+}
+
+SearchResult Engine::search(const Position& pos, const SearchLimits& limits,
+    const std::vector<uint64_t>& history, const InfoCallback& onInfo) {
+    stopRequested = false;
+    return run(pos, limits, history, onInfo);
+}
+
+void Engine::start(const Position& pos, const SearchLimits& limits, std::vector<uint64_t> history,
+    InfoCallback onInfo, DoneCallback onDone) {
+    wait();
+    // Cleared here rather than on the new thread, so a stop() right after start() counts
+    stopRequested = false;
+    searchThread = std::thread([this, pos, limits, history = std::move(history),
+        onInfo = std::move(onInfo), onDone = std::move(onDone)] {
+        SearchResult result = run(pos, limits, history, onInfo);
+        if (onDone) {
+            onDone(result);
+        }
+    });
+}
+
+void Engine::wait() {
+    if (searchThread.joinable()) {
+        searchThread.join();
+    }
+}
+
+SearchResult Engine::run(const Position& pos, const SearchLimits& limits,
+    const std::vector<uint64_t>& history, const InfoCallback& onInfo) {
+    tt.newSearch();
+    SearchShared shared{ tt, stopRequested, limits, Clock::now() };
+
+    // Workers are large (history and PV tables), keep them off the stack
+    std::vector<std::unique_ptr<SearchWorker>> workers;
+    for (int i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<SearchWorker>(i, shared));
+        workers.back()->setPosition(pos, history);
+    }
+
+    std::vector<SearchResult> results(threadCount);
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; ++i) {
+        helpers.emplace_back([&, i] { results[i] = workers[i]->iterate(nullptr); });
+    }
+    results[0] = workers[0]->iterate(onInfo);
+
+    // The main thread decides when the search ends
+    stopRequested = true;
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    // Take the deepest completed iteration, the main thread's on a tie
+    SearchResult result = std::move(results[0]);
+    for (int i = 1; i < threadCount; ++i) {
+        if (results[i].depth > result.depth && results[i].bestMove != MOVE_NONE) {
+            result = std::move(results[i]);
+        }
+    }
+
+    TTStats stats;
+    result.nodes = 0;
+    for (const auto& worker : workers) {
+        result.threadNodes.push_back(worker->nodeCount());
+        result.nodes += worker->nodeCount();
+        stats.probes += worker->tableStats().probes;
+        stats.hits += worker->tableStats().hits;
+    }
+    result.timeMs = elapsedMs(shared.startTime);
+    result.nps = result.nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(result.timeMs, 1));
+    result.hashfull = tt.hashfull();
+    result.ttHitRate = stats.hitRate();
+    return result;
+}
+
+void Engine::stop() {
+    stopRequested = true;
+}
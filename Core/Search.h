@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Position.h"
+#include "TranspositionTable.h"
+
+constexpr int MAX_PLY = 128;
+
+// Scores in centipawns. Mates are VALUE_MATE minus the distance in plies.
+constexpr int VALUE_DRAW = 0;
+constexpr int VALUE_MATE = 32000;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+inline bool isMateScore(int score) { return std::abs(score) >= VALUE_MATE_IN_MAX_PLY; }
+
+// Full moves until mate, negative when the side to move is being mated
+inline int mateInMoves(int score) {
+    return score > 0 ? (VALUE_MATE - score + 1) / 2 : -(VALUE_MATE + score) / 2;
+}
+
+// When to stop searching. The search ends at whichever limit comes first.
+struct SearchLimits {
+    int depth = MAX_PLY - 1;
+    uint64_t nodes = 0;   // Node budget, 0 for none
+    int64_t movetime = 0; // Milliseconds, 0 for none
+};
+
+// Outcome of a search, also reported after every completed iteration
+struct SearchResult {
+    Move bestMove = MOVE_NONE;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    uint64_t nps = 0;
+    int64_t timeMs = 0;
+    int hashfull = 0;
+    double ttHitRate = 0.0;
+    std::vector<Move> pv; // Principal variation, starting with bestMove
+    std::vector<uint64_t> threadNodes; // Nodes searched by each thread
+};
+
+using InfoCallback = std::function<void(const SearchResult&)>;
+
+using DoneCallback = std::function<void(const SearchResult&)>;
+
+class SearchWorker;
+
+// Alpha-beta search (negamax with principal variation search) driven by
+// iterative deepening with aspiration windows. Works on Position only, so
+// it runs without any window.
+//
+// With more than one thread the search is Lazy SMP: every thread searches
+// the same root sharing the transposition table, helpers skip some depths
+// so they get ahead of the main thread and fill the table for it.
+class Engine {
+private:
+    TranspositionTable tt;
+    std::atomic<bool> stopRequested{ false };
+    int threadCount = 1;
+    std::thread searchThread; // Background search started by start()
+
+    // search() without clearing a pending stop request
+    SearchResult run(const Position& pos, const SearchLimits& limits,
+        const std::vector<uint64_t>& history, const InfoCallback& onInfo);
+
+public:
+    // Constructor allocates a 16 MB transposition table
+    Engine();
+    ~Engine();
+
+    void setHashSize(size_t megabytes);
+
+    void clearHash();
+
+    // Number of search threads, at least 1
+    void setThreads(int threads);
+
+    int threads() const { return threadCount; }
+
+    // Search pos until a limit is reached or stop() is called. history holds
+    // the keys of the positions played before pos, for repetition detection.
+    // onInfo, if given, is called after each completed iteration.
+    SearchResult search(const Position& pos, const SearchLimits& limits,
+        const std::vector<uint64_t>& history = {}, const InfoCallback& onInfo = nullptr);
+
+    // Same search on a background thread, returns at once. onInfo and onDone
+    // are called from that thread, onDone with the final result. A stop()
+    // issued after start() returns is never lost, even if the thread has not
+    // begun searching yet. Waits for the previous background search first.
+    void start(const Position& pos, const SearchLimits& limits, std::vector<uint64_t> history,
+        InfoCallback onInfo, DoneCallback onDone);
+
+    // Block until the background search, if any, has finished and called onDone
+    void wait();
+
+    // Ask a running search to finish as soon as possible, safe from any thread
+    void stop();
+};
@@ -0,0 +1,897 @@
+#include "Tablebase.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include "MappedFile.h"
+#include "MoveGen.h"
+
+// File layout, all numbers little-endian:
+//   magic "CTB1", block size (4 bytes), entries per side (8), material name (16)
+//   block offsets for White to move, then for Black to move (8 bytes each,
+//   one per block plus the end offset), then the blocks
+// Each block holds BLOCK_SIZE entries as (run length - 1, value) byte pairs.
+// Entries are result codes: 0 for a draw, otherwise plies to mate + 1, an
+// odd number of plies being a win for the side to move. Entries of illegal
+// positions take whatever value makes the runs longest.
+namespace {
+
+    constexpr char TB_MAGIC[4] = { 'C', 'T', 'B', '1' };
+    constexpr const char* TB_EXTENSION = ".ctb";
+    constexpr uint32_t BLOCK_SIZE = 1024;
+    constexpr size_t NAME_SIZE = 16;
+    constexpr size_t HEADER_SIZE = 4 + 4 + 8 + NAME_SIZE;
+
+    constexpr uint8_t CODE_DRAW = 0;   // Also positions not decided yet during generation
+    constexpr uint8_t CODE_INVALID = 255;
+    constexpr int MAX_PLIES = 253;
+
+    constexpr uint8_t codeOf(int plies) { return static_cast<uint8_t>(plies + 1); }
+
+    TbResult resultOf(uint8_t code) {
+        if (code == CODE_DRAW || code == CODE_INVALID) {
+            return {};
+        }
+        int plies = code - 1;
+        return { (plies & 1) ? TbWdl::WIN : TbWdl::LOSS, plies };
+    }
+
+    // Pieces other than the king, in the order they appear in names and indexes
+    constexpr PieceType NameOrder[] = { QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
+    constexpr char PieceLetter[PIECE_TYPE_NB] = { 'P', 'N', 'B', 'R', 'Q', 'K' };
+    constexpr int PieceWorth[PIECE_TYPE_NB] = { 1, 3, 3, 5, 9, 0 };
+
+    // Without pawns the white king is brought into the a1-d1-d4 triangle
+    constexpr Square TriangleSquares[10] = { 0, 1, 2, 3, 9, 10, 11, 18, 19, 27 };
+
+    constexpr std::array<int8_t, SQUARE_NB> makeTriangleIndex() {
+        std::array<int8_t, SQUARE_NB> index{};
+        for (int8_t& i : index) {
+            i = -1;
+        }
+        for (int i = 0; i < 10; ++i) {
+            index[TriangleSquares[i]] = static_cast<int8_t>(i);
+        }
+        return index;
+    }
+
+    constexpr std::array<int8_t, SQUARE_NB> TriangleIndex = makeTriangleIndex();
+
+    constexpr Square flipDiagonal(Square s) { return ((s >> 3) | (s << 3)) & 63; }
+
+    // Position index of a material combination. Pieces are listed kings
+    // first, then White's and Black's other pieces in name order. The index
+    // of a placement is the white king's reduced square followed by one
+    // base-64 digit per other piece. Symmetric placements are reduced to
+    // one: mirroring files with pawns, any of the 8 board symmetries without.
+    class TbIndexer {
+    public:
+        PieceCode pieces[TB_MAX_PIECES] = {};
+        int count = 0;
+        bool hasPawns = false;
+        uint64_t entriesPerSide = 0;
+
+        TbIndexer() = default;
+
+        explicit TbIndexer(const TbMaterial& material) {
+            pieces[count++] = makePiece(Color::WHITE, KING);
+            pieces[count++] = makePiece(Color::BLACK, KING);
+            for (Color c : { Color::WHITE, Color::BLACK }) {
+                for (PieceType pt : NameOrder) {
+                    for (int i = 0; i < material.count[colorIndex(c)][pt]; ++i) {
+                        pieces[count++] = makePiece(c, pt);
+                    }
+                }
+            }
+            hasPawns = material.count[0][PAWN] || material.count[1][PAWN];
+            entriesPerSide = hasPawns ? 32 : 10;
+            for (int i = 1; i < count; ++i) {
+                entriesPerSide *= 64;
+            }
+        }
+
+        // Apply the symmetry that brings the placement to its reduced form
+        void canonicalize(Square* sq) const {
+            auto transform = [&](Square (*f)(Square)) {
+                for (int i = 0; i < count; ++i) {
+                    sq[i] = f(sq[i]);
+                }
+            };
+
+            if (fileOf(sq[0]) > 3) {
+                transform([](Square s) { return s ^ 7; });
+            }
+            if (hasPawns) {
+                return;
+            }
+            if (rankOf(sq[0]) > 3) {
+                transform([](Square s) { return s ^ 56; });
+            }
+            if (rankOf(sq[0]) > fileOf(sq[0])) {
+                transform(flipDiagonal);
+            }
+            else if (rankOf(sq[0]) == fileOf(sq[0])) {
+                // King on the diagonal: the first piece off it decides
+                for (int i = 1; i < count; ++i) {
+                    if (rankOf(sq[i]) != fileOf(sq[i])) {
+                        if (rankOf(sq[i]) > fileOf(sq[i])) {
+                            transform(flipDiagonal);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Index of a canonical placement
+        uint64_t index(const Square* sq) const {
+            uint64_t idx = hasPawns ? static_cast<uint64_t>(rankOf(sq[0]) * 4 + fileOf(sq[0])) : TriangleIndex[sq[0]];
+            for (int i = 1; i < count; ++i) {
+                idx = idx * 64 + sq[i];
+            }
+            return idx;
+        }
+
+        void decode(uint64_t idx, Square* sq) const {
+            for (int i = count - 1; i > 0; --i) {
+                sq[i] = static_cast<Square>(idx % 64);
+                idx /= 64;
+            }
+            sq[0] = hasPawns ? makeSquare(static_cast<int>(idx % 4), static_cast<int>(idx / 4)) : TriangleSquares[idx];
+        }
+
+        // Squares of the position's pieces in index order, colors swapped and
+        // the board turned around if 'flip' is set
+        void squaresOf(const Position& pos, bool flip, Square* sq) const {
+            Bitboard taken = 0;
+            for (int i = 0; i < count; ++i) {
+                Color c = colorOf(pieces[i]);
+                Bitboard b = pos.pieces(flip ? ~c : c, typeOf(pieces[i])) & ~taken;
+                Square s = lsb(b);
+                taken |= squareBB(s);
+                sq[i] = flip ? (s ^ 56) : s;
+            }
+        }
+
+        void setup(Position& pos, const Square* sq, Color side) const {
+            pos.clear();
+            for (int i = 0; i < count; ++i) {
+                pos.putPiece(pieces[i], sq[i]);
+            }
+            pos.setSideToMove(side);
+            pos.computeCheckInfo();
+        }
+
+        // Whether any piece of color 'by' attacks square s
+        bool attacked(const Square* sq, Color by, Square s) const {
+            Bitboard occupied = 0;
+            for (int i = 0; i < count; ++i) {
+                occupied |= squareBB(sq[i]);
+            }
+            for (int i = 0; i < count; ++i) {
+                if (colorOf(pieces[i]) != by) {
+                    continue;
+                }
+                PieceType pt = typeOf(pieces[i]);
+                Bitboard b = (pt == PAWN) ? pawnAttacks(by, sq[i]) : attacks(pt, sq[i], occupied);
+                if (b & squareBB(s)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Whether the index stands for a placement that can occur with this side to move
+        bool isValid(const Square* sq, Color side) const {
+            Bitboard occupied = 0;
+            for (int i = 0; i < count; ++i) {
+                if (occupied & squareBB(sq[i])) {
+                    return false;
+                }
+                occupied |= squareBB(sq[i]);
+                if (typeOf(pieces[i]) == PAWN && (rankOf(sq[i]) == 0 || rankOf(sq[i]) == 7)) {
+                    return false;
+                }
+            }
+
+            Square reduced[TB_MAX_PIECES];
+            std::copy(sq, sq + count, reduced);
+            canonicalize(reduced);
+            if (!std::equal(sq, sq + count, reduced)) {
+                return false;
+            }
+
+            // The side that just moved cannot be in check
+            Square king = sq[side == Color::WHITE ? 1 : 0];
+            return !attacked(sq, side, king);
+        }
+    };
+
+    uint64_t readLittleEndian(const unsigned char* p, int bytes) {
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; --i) {
+            value = (value << 8) | p[i];
+        }
+        return value;
+    }
+
+    void writeLittleEndian(std::vector<unsigned char>& out, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+        }
+    }
+
+    // Run f(begin, end) over [0, size) on several threads. Work is handed out
+    // in chunks so threads finishing early take more.
+    template<typename Fn>
+    void parallelFor(uint64_t size, int threads, const Fn& f) {
+        constexpr uint64_t CHUNK = 1 << 14;
+        std::atomic<uint64_t> next{ 0 };
+        auto worker = [&] {
+            uint64_t begin;
+            while ((begin = next.fetch_add(CHUNK)) < size) {
+                f(begin, std::min(size, begin + CHUNK));
+            }
+        };
+
+        std::vector<std::thread> helpers;
+        for (int t = 1; t < threads; ++t) {
+            helpers.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& t : helpers) {
+            t.join();
+        }
+    }
+
+    std::string tablePath(const std::string& directory, const std::string& name) {
+        return (std::filesystem::path(directory) / (name + TB_EXTENSION)).string();
+    }
+
+    bool isBareKings(const TbMaterial& m) {
+        return m.pieceCount() == 2;
+    }
+
+    // Orientation tables are built in: the side with more material is White
+    TbMaterial normalized(const TbMaterial& m) {
+        int worth[COLOR_NB] = {};
+        for (int c = 0; c < COLOR_NB; ++c) {
+            for (int pt = PAWN; pt < KING; ++pt) {
+                worth[c] += m.count[c][pt] * PieceWorth[pt];
+            }
+        }
+        TbMaterial other = m.flipped();
+        if (worth[1] > worth[0] || (worth[1] == worth[0] && other.name() < m.name())) {
+            return other;
+        }
+        return m;
+    }
+
+    // Materials one capture, one promotion or both at once lead to
+    std::vector<TbMaterial> conversions(const TbMaterial& m) {
+        std::vector<TbMaterial> result;
+        auto add = [&result](const TbMaterial& next) {
+            for (const TbMaterial& known : result) {
+                if (known.key() == next.key()) {
+                    return;
+                }
+            }
+            result.push_back(next);
+        };
+
+        for (int us = 0; us < COLOR_NB; ++us) {
+            int them = us ^ 1;
+            for (int captured = PAWN; captured < KING; ++captured) {
+                if (m.count[them][captured]) {
+                    TbMaterial next = m;
+                    --next.count[them][captured];
+                    add(next);
+                }
+            }
+            if (!m.count[us][PAWN]) {
+                continue;
+            }
+            for (int promoted = KNIGHT; promoted <= QUEEN; ++promoted) {
+                TbMaterial next = m;
+                --next.count[us][PAWN];
+                ++next.count[us][promoted];
+                add(next);
+
+                // Capturing while promoting, never a pawn on the last rank
+                for (int captured = KNIGHT; captured < KING; ++captured) {
+                    if (m.count[them][captured]) {
+                        TbMaterial both = next;
+                        --both.count[them][captured];
+                        add(both);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // Retrograde solver of one table. Values start as draws, checkmates are
+    // losses in 0. Pass n then finds the positions whose result is n plies:
+    //  - odd n: any position with a move into a loss in n - 1 is a win in n.
+    //    These are found by taking back moves from the losses in n - 1.
+    //  - even n: a position whose every move leads to a win for the opponent,
+    //    the slowest in n - 1, is a loss in n. Candidates are found by taking
+    //    back moves from the wins in n - 1 and then checked move by move.
+    // Moves leaving the table (captures, promotions) are looked up in the
+    // smaller tables once, up front. A result they settle at a later pass is
+    // kept as pending until that pass. Whatever is left at the end is a draw.
+    // En passant is not modelled, a double push is taken back like any other.
+    class TbGenerator {
+    private:
+        TbIndexer indexer;
+        const Tablebases& smaller;
+        int threads;
+        uint64_t entries;
+        std::unique_ptr<std::atomic<uint8_t>[]> values;  // Result codes, both sides to move
+        std::unique_ptr<std::atomic<uint8_t>[]> pending; // Plies at which a result falls due, 0 for none
+        std::unique_ptr<uint8_t[]> exits;                // Slowest loss through an exit, EXIT_SAVES if one draws or wins
+        std::atomic<bool> missingTable{ false };
+
+        static constexpr uint8_t EXIT_SAVES = 255;
+
+        Color sideOf(uint64_t i) const { return i < entries ? Color::WHITE : Color::BLACK; }
+
+        uint64_t slot(Color side, uint64_t idx) const { return side == Color::WHITE ? idx : entries + idx; }
+
+        static bool leavesTable(const Position& pos, Move m) {
+            return pos.isCapture(m) || typeOfMove(m) == PROMOTION;
+        }
+
+        uint8_t valueAfter(const Square* sq, Square from, Square to, Color side) const {
+            Square next[TB_MAX_PIECES];
+            std::copy(sq, sq + indexer.count, next);
+            for (int i = 0; i < indexer.count; ++i) {
+                if (next[i] == from) {
+                    next[i] = to;
+                    break;
+                }
+            }
+            indexer.canonicalize(next);
+            return values[slot(side, indexer.index(next))].load(std::memory_order_relaxed);
+        }
+
+        void initialize(uint64_t begin, uint64_t end);
+        void unmove(uint64_t i, int pass);
+        void confirmLoss(const Square* sq, Color side, uint64_t target, int pass);
+
+    public:
+        TbGenerator(const TbMaterial& material, const Tablebases& smaller, int threads)
+            : indexer(material), smaller(smaller), threads(threads), entries(indexer.entriesPerSide) {
+            values = std::make_unique<std::atomic<uint8_t>[]>(2 * entries);
+            pending = std::make_unique<std::atomic<uint8_t>[]>(2 * entries);
+            exits = std::make_unique<uint8_t[]>(2 * entries);
+        }
+
+        bool solve();
+
+        bool write(const std::string& path, const std::string& name, TbGenerationStats& stats) const;
+    };
+
+    void TbGenerator::initialize(uint64_t begin, uint64_t end) {
+        Position pos;
+        Square sq[TB_MAX_PIECES];
+
+        for (uint64_t i = begin; i < end; ++i) {
+            Color side = sideOf(i);
+            indexer.decode(i % entries, sq);
+            pending[i].store(0, std::memory_order_relaxed);
+            exits[i] = 0;
+            if (!indexer.isValid(sq, side)) {
+                values[i].store(CODE_INVALID, std::memory_order_relaxed);
+                continue;
+            }
+
+            indexer.setup(pos, sq, side);
+            MoveList moves;
+            generate<LEGAL>(pos, moves);
+            if (moves.size() == 0) {
+                values[i].store(pos.inCheck() ? codeOf(0) : CODE_DRAW, std::memory_order_relaxed);
+                continue;
+            }
+            values[i].store(CODE_DRAW, std::memory_order_relaxed);
+
+            // Results through captures and promotions, from the smaller tables
+            int fastestWin = MAX_PLIES + 1;
+            int slowestLoss = 0;
+            bool exitDraws = false;
+            bool staysInTable = false;
+            for (Move m : moves) {
+                if (!leavesTable(pos, m)) {
+                    staysInTable = true;
+                    continue;
+                }
+                Position next = pos;
+                next.doMove(m);
+                TbResult r;
+                if (!smaller.probe(next, r)) {
+                    missingTable = true;
+                    continue;
+                }
+                if (r.wdl == TbWdl::LOSS) {
+                    fastestWin = std::min(fastestWin, r.plies + 1);
+                }
+                else if (r.wdl == TbWdl::WIN) {
+                    slowestLoss = std::min(std::max(slowestLoss, r.plies + 1), MAX_PLIES - 1);
+                }
+                else {
+                    exitDraws = true;
+                }
+            }
+
+            if (fastestWin <= MAX_PLIES) {
+                exits[i] = EXIT_SAVES;
+                pending[i].store(static_cast<uint8_t>(fastestWin), std::memory_order_relaxed);
+            }
+            else if (exitDraws) {
+                exits[i] = EXIT_SAVES;
+            }
+            else {
+                exits[i] = static_cast<uint8_t>(slowestLoss);
+                // Every move leaves the table and loses
+                if (!staysInTable) {
+                    pending[i].store(static_cast<uint8_t>(slowestLoss), std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    // Check a candidate for a loss in 'pass' plies: every move must lead to a
+    // win for the opponent. If the slowest of them ends later, the loss is
+    // left pending until then.
+    void TbGenerator::confirmLoss(const Square* sq, Color side, uint64_t target, int pass) {
+        if (exits[target] == EXIT_SAVES) {
+            return;
+        }
+        int slowest = exits[target];
+
+        Position pos;
+        indexer.setup(pos, sq, side);
+        MoveList moves;
+        generate<LEGAL>(pos, moves);
+        for (Move m : moves) {
+            if (leavesTable(pos, m)) {
+                continue;
+            }
+            TbResult r = resultOf(valueAfter(sq, fromSq(m), toSq(m), ~side));
+            if (r.wdl != TbWdl::WIN || r.plies >= pass) {
+                return;
+            }
+            slowest = std::max(slowest, r.plies + 1);
+        }
+
+        if (slowest <= pass) {
+            values[target].store(codeOf(pass), std::memory_order_relaxed);
+        }
+        else {
+            pending[target].store(static_cast<uint8_t>(slowest), std::memory_order_relaxed);
+        }
+    }
+
+    // Take back every move that could have led to position i, settled at
+    // pass - 1, and update the positions before it
+    void TbGenerator::unmove(uint64_t i, int pass) {
+        Square sq[TB_MAX_PIECES];
+        Color side = sideOf(i);
+        Color mover = ~side;
+        bool settlesWins = !((pass - 1) & 1); // Position i is a loss, what led to it wins
+        indexer.decode(i % entries, sq);
+
+        Bitboard occupied = 0;
+        for (int k = 0; k < indexer.count; ++k) {
+            occupied |= squareBB(sq[k]);
+        }
+        Square sideKing = sq[side == Color::WHITE ? 0 : 1];
+
+        for (int k = 0; k < indexer.count; ++k) {
+            if (colorOf(indexer.pieces[k]) != mover) {
+                continue;
+            }
+
+            Square to = sq[k];
+            PieceType pt = typeOf(indexer.pieces[k]);
+            Bitboard origins;
+            if (pt == PAWN) {
+                // Single push back, and double push back from the fourth rank
+                origins = 0;
+                Square back = to - pawnPush(mover);
+                if (relativeRank(mover, to) >= 2 && !(occupied & squareBB(back))) {
+                    origins |= squareBB(back);
+                    if (relativeRank(mover, to) == 3 && !(occupied & squareBB(back - pawnPush(mover)))) {
+                        origins |= squareBB(back - pawnPush(mover));
+                    }
+                }
+            }
+            else {
+                origins = attacks(pt, to, occupied) & ~occupied;
+            }
+
+            while (origins) {
+                Square before[TB_MAX_PIECES];
+                std::copy(sq, sq + indexer.count, before);
+                before[k] = popLsb(origins);
+
+                // The side not to move may not be in check before the move
+                if (indexer.attacked(before, mover, sideKing)) {
+                    continue;
+                }
+                indexer.canonicalize(before);
+                uint64_t target = slot(mover, indexer.index(before));
+                if (values[target].load(std::memory_order_relaxed) != CODE_DRAW) {
+                    continue;
+                }
+
+                if (settlesWins) {
+                    values[target].store(codeOf(pass), std::memory_order_relaxed);
+                }
+                else if (pending[target].load(std::memory_order_relaxed) == 0) {
+                    confirmLoss(before, mover, target, pass);
+                }
+            }
+        }
+    }
+
+    bool TbGenerator::solve() {
+        parallelFor(2 * entries, threads, [this](uint64_t begin, uint64_t end) { initialize(begin, end); });
+        if (missingTable) {
+            return false;
+        }
+
+        // No result can fall due after the slowest one an exit settles
+        int lastPending = 0;
+        for (uint64_t i = 0; i < 2 * entries; ++i) {
+            lastPending = std::max<int>(lastPending, pending[i].load(std::memory_order_relaxed));
+            if (exits[i] != EXIT_SAVES) {
+                lastPending = std::max<int>(lastPending, exits[i]);
+            }
+        }
+
+        int quietPasses = 0;
+        for (int pass = 1; pass <= MAX_PLIES; ++pass) {
+            uint8_t previous = codeOf(pass - 1);
+            std::atomic<uint64_t> settled{ 0 };
+
+            parallelFor(2 * entries, threads, [&](uint64_t begin, uint64_t end) {
+                for (uint64_t i = begin; i < end; ++i) {
+                    if (values[i].load(std::memory_order_relaxed) == previous) {
+                        unmove(i, pass);
+                    }
+                }
+            });
+
+            // Results falling due now, and the count of everything settled this pass
+            parallelFor(2 * entries, threads, [&](uint64_t begin, uint64_t end) {
+                uint64_t count = 0;
+                for (uint64_t i = begin; i < end; ++i) {
+                    uint8_t v = values[i].load(std::memory_order_relaxed);
+                    if (v == CODE_DRAW && pending[i].load(std::memory_order_relaxed) == pass) {
+                        values[i].store(codeOf(pass), std::memory_order_relaxed);
+                        v = codeOf(pass);
+                    }
+                    count += (v == codeOf(pass));
+                }
+                settled += count;
+            });
+
+            // Two passes without a result and nothing pending means nothing can follow
+            quietPasses = settled ? 0 : quietPasses + 1;
+            if (quietPasses >= 2 && pass >= lastPending) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool TbGenerator::write(const std::string& path, const std::string& name, TbGenerationStats& stats) const {
+        std::vector<unsigned char> header(TB_MAGIC, TB_MAGIC + 4);
+        writeLittleEndian(header, BLOCK_SIZE, 4);
+        writeLittleEndian(header, entries, 8);
+        for (size_t i = 0; i < NAME_SIZE; ++i) {
+            header.push_back(i < name.size() ? static_cast<unsigned char>(name[i]) : 0);
+        }
+
+        // Compress both sides, illegal entries continue the current run
+        uint64_t blocks = (entries + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        std::vector<uint64_t> offsets;
+        std::vector<unsigned char> data;
+        uint64_t dataStart = HEADER_SIZE + 2 * (blocks + 1) * 8;
+        for (int side = 0; side < COLOR_NB; ++side) {
+            const std::atomic<uint8_t>* v = values.get() + side * entries;
+            uint8_t current = CODE_DRAW;
+            for (uint64_t block = 0; block < blocks; ++block) {
+                offsets.push_back(dataStart + data.size());
+                uint64_t end = std::min(entries, (block + 1) * BLOCK_SIZE);
+                uint64_t i = block * BLOCK_SIZE;
+                while (i < end) {
+                    uint8_t first = v[i].load(std::memory_order_relaxed);
+                    if (first != CODE_INVALID) {
+                        current = first;
+                    }
+                    uint64_t run = 1;
+                    while (i + run < end && run < 256) {
+                        uint8_t next = v[i + run].load(std::memory_order_relaxed);
+                        if (next != current && next != CODE_INVALID) {
+                            break;
+                        }
+                        ++run;
+                    }
+                    data.push_back(static_cast<unsigned char>(run - 1));
+                    data.push_back(current);
+                    i += run;
+                }
+            }
+            offsets.push_back(dataStart + data.size());
+        }
+        for (uint64_t offset : offsets) {
+            writeLittleEndian(header, offset, 8);
+        }
+
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool written = std::fwrite(header.data(), 1, header.size(), file) == header.size()
+            && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        written = (std::fclose(file) == 0) && written;
+
+        for (uint64_t i = 0; i < 2 * entries; ++i) {
+            uint8_t code = values[i].load(std::memory_order_relaxed);
+            if (code == CODE_INVALID) {
+                continue;
+            }
+            ++stats.positions;
+            TbResult r = resultOf(code);
+            stats.wins += (r.wdl == TbWdl::WIN);
+            stats.draws += (r.wdl == TbWdl::DRAW);
+            stats.losses += (r.wdl == TbWdl::LOSS);
+            stats.longestMate = std::max(stats.longestMate, r.plies);
+        }
+        stats.fileSize = header.size() + data.size();
+        return written;
+    }
+
+    // Build the table for m unless its file exists, the ones it converts into first
+    bool ensureTable(const TbMaterial& m, const std::string& directory, int threads, const TbGenerationCallback& onTable) {
+        if (isBareKings(m)) {
+            return true;
+        }
+        TbMaterial material = normalized(m);
+        std::string name = material.name();
+        std::string path = tablePath(directory, name);
+        if (std::filesystem::exists(path)) {
+            return true;
+        }
+
+        for (const TbMaterial& next : conversions(material)) {
+            if (!ensureTable(next, directory, threads, onTable)) {
+                return false;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Tablebases smaller;
+        smaller.load(directory);
+        TbGenerator generator(material, smaller, threads);
+        if (!generator.solve()) {
+            return false;
+        }
+
+        TbGenerationStats stats;
+        stats.name = name;
+        if (!generator.write(path, name, stats)) {
+            return false;
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (onTable) {
+            onTable(stats);
+        }
+        return true;
+    }
+}
+
+bool TbMaterial::parse(std::string_view name) {
+    *this = TbMaterial();
+    size_t split = name.find('v');
+    if (split == std::string_view::npos) {
+        return false;
+    }
+
+    std::string_view sides[COLOR_NB] = { name.substr(0, split), name.substr(split + 1) };
+    for (int c = 0; c < COLOR_NB; ++c) {
+        if (sides[c].empty() || sides[c][0] != 'K') {
+            return false;
+        }
+        for (char letter : sides[c]) {
+            const char* found = std::find(PieceLetter, PieceLetter + PIECE_TYPE_NB, letter);
+            if (found == PieceLetter + PIECE_TYPE_NB) {
+                return false;
+            }
+            ++count[c][found - PieceLetter];
+        }
+        if (count[c][KING] != 1) {
+            return false;
+        }
+    }
+    return pieceCount() <= TB_MAX_PIECES;
+}
+
+std::string TbMaterial::name() const {
+    std::string result;
+    for (int c = 0; c < COLOR_NB; ++c) {
+        result += c == 0 ? "K" : "vK";
+        for (PieceType pt : NameOrder) {
+            result.append(count[c][pt], PieceLetter[pt]);
+        }
+    }
+    return result;
+}
+
+int TbMaterial::pieceCount() const {
+    int total = 0;
+    for (const auto& side : count) {
+        for (uint8_t n : side) {
+            total += n;
+        }
+    }
+    return total;
+}
+
+uint64_t TbMaterial::key() const {
+    uint64_t result = 0;
+    for (int c = 0; c < COLOR_NB; ++c) {
+        for (int pt = PAWN; pt < KING; ++pt) {
+            result |= static_cast<uint64_t>(count[c][pt]) << (4 * (c * 5 + pt));
+        }
+    }
+    return result;
+}
+
+TbMaterial TbMaterial::flipped() const {
+    TbMaterial result;
+    for (int pt = 0; pt < PIECE_TYPE_NB; ++pt) {
+        result.count[0][pt] = count[1][pt];
+        result.count[1][pt] = count[0][pt];
+    }
+    return result;
+}
+
+uint64_t materialKey(const Position& pos, bool flip) {
+    uint64_t result = 0;
+    for (int c = 0; c < COLOR_NB; ++c) {
+        Color color = static_cast<Color>(c);
+        for (int pt = PAWN; pt < KING; ++pt) {
+            uint64_t n = popcount(pos.pieces(flip ? ~color : color, static_cast<PieceType>(pt)));
+            result |= std::min<uint64_t>(n, 15) << (4 * (c * 5 + pt));
+        }
+    }
+    return result;
+}
+
+struct Tablebases::Table {
+    MappedFile file;
+    TbIndexer indexer;
+    uint64_t key = 0;
+    uint64_t blocks = 0;
+    const unsigned char* bytes = nullptr;
+
+    uint8_t value(Color side, uint64_t idx) const {
+        uint64_t block = idx / BLOCK_SIZE;
+        uint64_t offsetAt = HEADER_SIZE + (colorIndex(side) * (blocks + 1) + block) * 8;
+        const unsigned char* p = bytes + readLittleEndian(bytes + offsetAt, 8);
+        uint64_t remaining = idx % BLOCK_SIZE;
+        while (remaining > p[0]) {
+            remaining -= p[0] + 1u;
+            p += 2;
+        }
+        return p[1];
+    }
+};
+
+Tablebases::Tablebases() = default;
+
+Tablebases::~Tablebases() = default;
+
+int Tablebases::load(const std::string& directory) {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == TB_EXTENSION) {
+            loadFile(entry.path().string());
+        }
+    }
+    return static_cast<int>(tables.size());
+}
+
+bool Tablebases::loadFile(const std::string& path) {
+    auto table = std::make_unique<Table>();
+    if (!table->file.open(path) || table->file.size() < HEADER_SIZE) {
+        return false;
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(table->file.data());
+    if (!std::equal(TB_MAGIC, TB_MAGIC + 4, bytes) || readLittleEndian(bytes + 4, 4) != BLOCK_SIZE) {
+        return false;
+    }
+
+    std::string name(reinterpret_cast<const char*>(bytes + 16), NAME_SIZE);
+    name.resize(name.find('\0') == std::string::npos ? NAME_SIZE : name.find('\0'));
+    TbMaterial material;
+    if (!material.parse(name)) {
+        return false;
+    }
+
+    table->indexer = TbIndexer(material);
+    table->key = material.key();
+    table->blocks = (table->indexer.entriesPerSide + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    table->bytes = bytes;
+    if (readLittleEndian(bytes + 8, 8) != table->indexer.entriesPerSide
+        || table->file.size() < HEADER_SIZE + 2 * (table->blocks + 1) * 8
+        || readLittleEndian(bytes + HEADER_SIZE + (2 * table->blocks + 1) * 8, 8) != table->file.size()) {
+        return false;
+    }
+
+    if (find(table->key)) {
+        return true;
+    }
+    largest = std::max(largest, material.pieceCount());
+    tables.push_back(std::move(table));
+    return true;
+}
+
+const Tablebases::Table* Tablebases::find(uint64_t key) const {
+    for (const auto& table : tables) {
+        if (table->key == key) {
+            return table.get();
+        }
+    }
+    return nullptr;
+}
+
+bool Tablebases::probe(const Position& pos, TbResult& result) const {
+    // Indexing starts from the kings, a position must have one of each
+    if (popcount(pos.pieces(Color::WHITE, KING)) != 1 || popcount(pos.pieces(Color::BLACK, KING)) != 1) {
+        return false;
+    }
+    int pieces = popcount(pos.pieces());
+    if (pieces == 2) {
+        result = TbResult();
+        return true;
+    }
+    if (pieces > largest || pos.castlingRights() || pos.enPassantSquare() != NO_SQUARE) {
+        return false;
+    }
+
+    // Tables are stored for one orientation, the other is probed with colors swapped
+    bool flip = false;
+    const Table* table = find(materialKey(pos));
+    if (!table) {
+        flip = true;
+        table = find(materialKey(pos, true));
+    }
+    if (!table) {
+        return false;
+    }
+
+    Square sq[TB_MAX_PIECES];
+    table->indexer.squaresOf(pos, flip, sq);
+    table->indexer.canonicalize(sq);
+    Color side = flip ? ~pos.sideToMove() : pos.sideToMove();
+    result = resultOf(table->value(side, table->indexer.index(sq)));
+    return true;
+}
+
+bool generateTablebase(const std::string& material, const std::string& directory, int threads,
+    const TbGenerationCallback& onTable) {
+    TbMaterial m;
+    if (!m.parse(material)) {
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    return ensureTable(m, directory, std::max(1, threads), onTable);
+}
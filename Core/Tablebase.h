@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Position.h"
+
+// Endgame tablebases: for every position of a small material combination,
+// whether the side to move wins, draws or loses, and in how many plies the
+// game ends in mate with best play on both sides (distance to mate).
+// Positions with castling rights or an en passant square are not covered.
+
+constexpr int TB_MAX_PIECES = 5; // Kings included
+
+enum class TbWdl : int8_t { LOSS = -1, DRAW = 0, WIN = 1 };
+
+// Value of a position for the side to move
+struct TbResult {
+    TbWdl wdl = TbWdl::DRAW;
+    int plies = 0; // Plies until mate with best play, 0 for draws
+};
+
+// Pieces of both sides, kings included, named like "KRvKP"
+struct TbMaterial {
+    uint8_t count[COLOR_NB][PIECE_TYPE_NB] = {};
+
+    // Read a name such as "KQvK", returns false if it is not one side's
+    // pieces, 'v', the other side's pieces, each starting with one king
+    bool parse(std::string_view name);
+
+    std::string name() const;
+
+    int pieceCount() const;
+
+    // Same for every position with this material, as computed by materialKey
+    uint64_t key() const;
+
+    // White's pieces given to Black and the other way round
+    TbMaterial flipped() const;
+};
+
+// Material key of a position, with the colors swapped if 'flip' is set
+uint64_t materialKey(const Position& pos, bool flip = false);
+
+// Memory-mapped tablebase files. Probing decodes one small block of the
+// compressed file in place, nothing is loaded up front.
+class Tablebases {
+private:
+    struct Table;
+    std::vector<std::unique_ptr<Table>> tables;
+    int largest = 0; // Most pieces in any loaded table
+
+    const Table* find(uint64_t key) const;
+
+public:
+    Tablebases();
+    ~Tablebases();
+
+    // Map every table file found in the directory, returns how many there are
+    int load(const std::string& directory);
+
+    // Map one table file, returns false if it is missing or malformed
+    bool loadFile(const std::string& path);
+
+    size_t size() const { return tables.size(); }
+
+    int maxPieces() const { return largest; }
+
+    // Value of the position for the side to move. Returns false if no table
+    // covers it or a side does not have exactly one king. Bare kings are
+    // always a draw.
+    bool probe(const Position& pos, TbResult& result) const;
+};
+
+struct TbGenerationStats {
+    std::string name;
+    uint64_t positions = 0; // Legal positions in the table, both sides to move
+    uint64_t wins = 0;      // Wins and losses for the side to move
+    uint64_t draws = 0;
+    uint64_t losses = 0;
+    int longestMate = 0;    // Longest distance to mate in plies
+    uint64_t fileSize = 0;
+    double seconds = 0;
+};
+
+using TbGenerationCallback = std::function<void(const TbGenerationStats&)>;
+
+// Build the table for a material combination by retrograde analysis, after
+// building the tables its captures and promotions lead into, and write them
+// to the directory. Tables already there are reused. The unmove passes are
+// split across the given number of threads. onTable is called for each
+// table built. Returns false for bad material or when a file cannot be written.
+bool generateTablebase(const std::string& material, const std::string& directory, int threads,
+    const TbGenerationCallback& onTable = nullptr);
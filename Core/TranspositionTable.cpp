@@ -0,0 +1,197 @@
+#include "TranspositionTable.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <malloc.h>
+#endif
+
+namespace {
+
+    uint64_t packData(Move move, int score, int depth, Bound bound, uint8_t generation) {
+        return static_cast<uint64_t>(move)
+            | static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(score))) << 16
+            | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 32
+            | static_cast<uint64_t>(bound | (generation << 2)) << 40;
+    }
+
+    int dataDepth(uint64_t data) { return static_cast<int8_t>((data >> 32) & 0xFF); }
+
+    uint8_t dataGeneration(uint64_t data) { return static_cast<uint8_t>((data >> 42) & 0x3F); }
+
+    // Scale a key onto [0, n) using the high half of a 128-bit product
+    size_t scaleKey(uint64_t key, size_t n) {
+#if defined(_MSC_VER)
+        return static_cast<size_t>(__umulh(key, n));
+#else
+        return static_cast<size_t>((static_cast<unsigned __int128>(key) * n) >> 64);
+#endif
+    }
+
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+}
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+void TranspositionTable::release() {
+    if (buckets) {
+#if defined(_MSC_VER)
+        _aligned_free(buckets);
+#else
+        std::free(buckets);
+#endif
+    }
+    buckets = nullptr;
+    bucketCount = 0;
+    allocatedBytes = 0;
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    release();
+
+    size_t bytes = megabytes * 1024 * 1024;
+    if (bytes < sizeof(Bucket)) {
+        return;
+    }
+
+#if defined(_MSC_VER)
+    void* memory = _aligned_malloc(bytes, 64);
+#elif defined(__linux__)
+    // Huge page alignment lets the kernel back the table with 2 MB pages,
+    // which removes most TLB misses on random probes
+    bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void* memory = std::aligned_alloc(HUGE_PAGE_SIZE, bytes);
+    if (memory) {
+        madvise(memory, bytes, MADV_HUGEPAGE);
+    }
+#else
+    void* memory = std::aligned_alloc(64, bytes);
+#endif
+
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+
+    buckets = static_cast<Bucket*>(memory);
+    bucketCount = bytes / sizeof(Bucket);
+    allocatedBytes = bytes;
+    clear();
+}
+
+void TranspositionTable::clear(int threads) {
+    generation = 0;
+    if (!bucketCount) {
+        return;
+    }
+    if (threads <= 1) {
+        std::memset(static_cast<void*>(buckets), 0, bucketCount * sizeof(Bucket));
+        return;
+    }
+
+    // Touching the memory from several threads also spreads it over NUMA nodes
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back([this, i, threads]() {
+            size_t begin = bucketCount * i / threads;
+            size_t end = bucketCount * (i + 1) / threads;
+            std::memset(static_cast<void*>(buckets + begin), 0, (end - begin) * sizeof(Bucket));
+        });
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key) const {
+    return buckets[scaleKey(key, bucketCount)];
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& result, TTStats& stats) const {
+    ++stats.probes;
+    if (!bucketCount) {
+        return false;
+    }
+
+    for (const Entry& entry : bucketFor(key).entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && data) {
+            result.move = static_cast<Move>(data & 0xFFFF);
+            result.score = static_cast<int16_t>((data >> 16) & 0xFFFF);
+            result.depth = dataDepth(data);
+            result.bound = static_cast<Bound>((data >> 40) & 3);
+            ++stats.hits;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, Bound bound) {
+    if (!bucketCount) {
+        return;
+    }
+
+    // Reuse the entry of the same position, otherwise replace the least
+    // valuable one: shallow entries from old searches go first
+    Bucket& bucket = bucketFor(key);
+    Entry* replace = &bucket.entries[0];
+    int replaceWorth = 1 << 30;
+    for (Entry& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key) {
+            // Keep a deeper result and its move unless this one is exact
+            if (bound != BOUND_EXACT && depth < dataDepth(data) - 2 && dataGeneration(data) == generation) {
+                return;
+            }
+            if (move == MOVE_NONE) {
+                move = static_cast<Move>(data & 0xFFFF);
+            }
+            replace = &entry;
+            break;
+        }
+        int age = (generation - dataGeneration(data)) & 0x3F;
+        int worth = data ? dataDepth(data) - 8 * age : -(1 << 30);
+        if (worth < replaceWorth) {
+            replaceWorth = worth;
+            replace = &entry;
+        }
+    }
+
+    uint64_t data = packData(move, score, depth, bound, generation);
+    replace->check.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::prefetch(uint64_t key) const {
+    if (bucketCount) {
+#if defined(_MSC_VER)
+        _mm_prefetch(reinterpret_cast<const char*>(&bucketFor(key)), _MM_HINT_T0);
+#else
+        __builtin_prefetch(&bucketFor(key));
+#endif
+    }
+}
+
+int TranspositionTable::hashfull() const {
+    int used = 0;
+    size_t sample = std::min<size_t>(1000 / BUCKET_SIZE, bucketCount);
+    for (size_t i = 0; i < sample; ++i) {
+        for (const Entry& entry : buckets[i].entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            used += (data && dataGeneration(data) == generation) ? 1 : 0;
+        }
+    }
+    return sample ? used * 1000 / static_cast<int>(sample * BUCKET_SIZE) : 0;
+}
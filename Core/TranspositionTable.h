@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "Move.h"
+
+// What a stored score says about the true value of the position
+enum Bound : uint8_t {
+    BOUND_NONE,
+    BOUND_UPPER, // Score is at most this (fail low)
+    BOUND_LOWER, // Score is at least this (fail high)
+    BOUND_EXACT = BOUND_UPPER | BOUND_LOWER
+};
+
+// Unpacked contents of a table entry
+struct TTData {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Probe counters, kept by each search thread so the shared table is never
+// written just to count
+struct TTStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+
+    double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+};
+
+// Transposition table shared by all search threads without locks.
+// Each entry is two 64-bit words written with relaxed atomics: the data
+// word and the position key XOR the data word. A reader that sees a torn
+// pair (words from two different writes) fails the key check and treats
+// the entry as a miss. Four entries form a 64-byte bucket, one cache line.
+class TranspositionTable {
+private:
+    struct Entry {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;  // move 16 | score 16 | depth 8 | bound 2, generation 6
+    };
+
+    static constexpr int BUCKET_SIZE = 4;
+
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_SIZE];
+    };
+
+    Bucket* buckets = nullptr;
+    size_t bucketCount = 0;
+    size_t allocatedBytes = 0;
+    uint8_t generation = 0; // Age of the current search, 6 bits
+
+    Bucket& bucketFor(uint64_t key) const;
+
+    void release();
+
+public:
+    TranspositionTable() = default;
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+    ~TranspositionTable();
+
+    // Reallocate to the given size in megabytes and clear it. On Linux the
+    // memory is 2 MB aligned and advised for transparent huge pages.
+    // Must not be called while a search is running.
+    void resize(size_t megabytes);
+
+    // Zero all entries, using the given number of threads for large tables
+    void clear(int threads = 1);
+
+    size_t sizeMb() const { return allocatedBytes / (1024 * 1024); }
+
+    // Start a new search so entries from earlier ones are replaced first
+    void newSearch() { generation = (generation + 1) & 0x3F; }
+
+    // Look up a position. Returns false on a miss.
+    bool probe(uint64_t key, TTData& result, TTStats& stats) const;
+
+    void store(uint64_t key, Move move, int score, int depth, Bound bound);
+
+    // Start loading the bucket of a position into the cache
+    void prefetch(uint64_t key) const;
+
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+};
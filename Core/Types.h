@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+
+// Enumeration for piece colors
+enum class Color : uint8_t { WHITE, BLACK };
+
+// Piece kinds, in the order used to index the position's bitboards
+enum PieceType : uint8_t { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NO_PIECE_TYPE };
+
+// Piece kind and color packed into one byte: bit 3 is the color, bits 0-2 the kind
+enum PieceCode : uint8_t { NO_PIECE = NO_PIECE_TYPE };
+
+// Squares are numbered from 0 (a1) to 63 (h8), rank by rank
+using Square = int;
+
+constexpr int COLOR_NB = 2;
+constexpr int PIECE_TYPE_NB = 6;
+constexpr int SQUARE_NB = 64;
+constexpr Square NO_SQUARE = SQUARE_NB;
+
+constexpr int colorIndex(Color c) { return static_cast<int>(c); }
+
+// Opposite color
+constexpr Color operator~(Color c) { return static_cast<Color>(static_cast<int>(c) ^ 1); }
+
+constexpr PieceCode makePiece(Color c, PieceType pt) { return static_cast<PieceCode>((colorIndex(c) << 3) | pt); }
+
+constexpr PieceType typeOf(PieceCode p) { return static_cast<PieceType>(p & 7); }
+
+constexpr Color colorOf(PieceCode p) { return static_cast<Color>(p >> 3); }
+
+constexpr Square makeSquare(int file, int rank) { return rank * 8 + file; }
+
+constexpr int fileOf(Square s) { return s & 7; }
+
+constexpr int rankOf(Square s) { return s >> 3; }
+
+// Castling rights of both sides packed as bit flags
+enum CastlingRights : uint8_t {
+    NO_CASTLING = 0,
+    WHITE_OO = 1,
+    WHITE_OOO = 2,
+    BLACK_OO = 4,
+    BLACK_OOO = 8,
+    ANY_CASTLING = WHITE_OO | WHITE_OOO | BLACK_OO | BLACK_OOO
+};
+
+// State of a game as judged from its current position
+enum class GameStatus : uint8_t {
+    ONGOING,
+    CHECKMATE,
+    STALEMATE,
+    DRAW_FIFTY_MOVES,
+    DRAW_INSUFFICIENT_MATERIAL,
+    TABLEBASE_WIN,  // Adjudicated from the endgame tablebases, for the side to move
+    TABLEBASE_LOSS,
+    TABLEBASE_DRAW
+};
+
+// Square offsets of one step in each direction, North is towards rank 8
+enum Direction : int {
+    NORTH = 8,
+    SOUTH = -8,
+    EAST = 1,
+    WEST = -1,
+    NORTH_EAST = NORTH + EAST,
+    NORTH_WEST = NORTH + WEST,
+    SOUTH_EAST = SOUTH + EAST,
+    SOUTH_WEST = SOUTH + WEST
+};
+
+// Same square seen from the given side, so rank 0 is always the home rank
+constexpr Square relativeSquare(Color c, Square s) { return s ^ (colorIndex(c) * 56); }
+
+constexpr int relativeRank(Color c, Square s) { return rankOf(relativeSquare(c, s)); }
+
+// Square offset of a single pawn push
+constexpr int pawnPush(Color c) { return c == Color::WHITE ? 8 : -8; }
@@ -0,0 +1,41 @@
+#pragma once
+#include "Types.h"
+
+// Random keys XORed together to identify a position: one per piece on each
+// square, per castling rights combination, per en passant file and for
+// Black to move. Generated by the compiler from a fixed seed.
+struct ZobristKeys {
+    uint64_t psq[16][SQUARE_NB]; // Indexed by PieceCode and square
+    uint64_t castling[ANY_CASTLING + 1];
+    uint64_t enPassant[8];       // Indexed by file
+    uint64_t side;               // Black to move
+};
+
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys{};
+    uint64_t state = 1070372;
+
+    // xorshift64*
+    auto next = [&state]() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    };
+
+    for (auto& squares : keys.psq) {
+        for (uint64_t& key : squares) {
+            key = next();
+        }
+    }
+    for (uint64_t& key : keys.castling) {
+        key = next();
+    }
+    for (uint64_t& key : keys.enPassant) {
+        key = next();
+    }
+    keys.side = next();
+    return keys;
+}
+
+inline constexpr ZobristKeys Zobrist = makeZobristKeys();
@@ -1,16 +1,17 @@
 ﻿#include "Piece.h"
 
 // Constructor
-Piece::Piece(Color color, sf::Vector2i position)
-    : color(color), position(position) {}
-
-// Destructor
-Piece::~Piece() {}
+Piece::Piece(Color color, PieceType type, sf::Vector2i position)
+    : color(color), type(type), position(position) {
+    const TextureCache& textures = TextureCache::instance();
+    sprite.setTexture(textures.getAtlas());
+    sprite.setTextureRect(textures.pieceRect(color, type));
+}
 
 // Draw method
 void Piece::draw(sf::RenderWindow& window           ) {
     // TODO: Check if in window.draw() this check isn't already present
-    if (!texture.getSize().x || !texture.getSize().y) {
+    if (!TextureCache::instance().isLoaded()) {
         return;
     }
     window.draw(sprite);
@@ -29,14 +30,6 @@ void Piece::setPosition(sf::Vector2i newPosition) { position = newPosition; }
 
 Color Piece::getColor() const { return color; }
 
-// Load texture
-bool Piece::loadTexture(const std::string& filename) {
-    if (!texture.loadFromFile(filename)) {
-        std::cerr << "Error loading texture: " << filename << std::endl;
-        return false;
-    }
-    sprite.setTexture(texture);
-    return true;
-}
+PieceType Piece::getType() const { return type; }
 
 
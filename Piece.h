@@ -1,30 +1,33 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <iostream>
-#include "globals.h"
+#include "Core/Bitboard.h"
+#include "TextureCache.h"
 
-// Enumeration for piece colors
-enum class Color { WHITE, BLACK };
+// Convert board coordinates (column, row from the top) to a square index and back.
+// Row 0 is the top of the window, which is the eighth rank.
+inline Square toSquare(sf::Vector2i pos) { return makeSquare(pos.x, 7 - pos.y); }
 
-// Base class for all pieces
+inline sf::Vector2i toBoardPosition(Square s) { return sf::Vector2i(fileOf(s), 7 - rankOf(s)); }
+
+// Sprite of one piece on the board. The kind is a plain PieceType and all
+// move rules live in Position, so there is no per-kind subclass and no
+// virtual dispatch.
 class Piece {
-protected:
+private:
     Color color;                 // Color of the piece (white or black)
+    PieceType type;              // Kind of the piece (pawn, knight, ...)
     sf::Vector2i position;       // Position of the piece on the board (row, column)
-    sf::Texture texture;         // Texture for the piece image
     const float tileSize = 100.f;
 
 public:
-    sf::Sprite sprite;           // SFML sprite for drawing the piece
+    sf::Sprite sprite;           // SFML sprite for drawing the piece, a part of the shared atlas
     
-    // Constructor initializes the piece with color and position
-    Piece(Color color, sf::Vector2i position);
-
-    // Virtual destructor
-    virtual ~Piece();
+    // Constructor initializes the piece with color, kind and position
+    Piece(Color color, PieceType type, sf::Vector2i position);
 
-    // Virtual method to draw the piece on the window
-    virtual void draw(sf::RenderWindow& window);
+    // Draw the piece on the window on its own, the board batches all pieces instead
+    void draw(sf::RenderWindow& window);
 
     void snapToGrid();
 
@@ -32,11 +35,7 @@ public:
 
     Color getColor() const;
 
-    void setPosition(sf::Vector2i newPosition);
-
-    bool loadTexture(const std::string& filename);
-
-    // Pure virtual method to validate moves, to be implemented in derived classes
-    virtual bool isValidMove(sf::Vector2i newPosition, sf::Vector2i position, Piece* targetPiece) const = 0;
+    PieceType getType() const;
 
+    void setPosition(sf::Vector2i newPosition);
 };
@@ -0,0 +1,49 @@
+#include "TextureCache.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace {
+
+    // File names in Sprites/, indexed by PieceType
+    const char* pieceNames[PIECE_TYPE_NB] = { "pawn", "knight", "bishop", "rook", "queen", "king" };
+}
+
+// Constructor decodes the 12 sprites and uploads them as one texture
+TextureCache::TextureCache() {
+    sf::Image images[COLOR_NB][PIECE_TYPE_NB];
+    bool ok = true;
+    for (int c = 0; c < COLOR_NB; ++c) {
+        for (int pt = PAWN; pt <= KING; ++pt) {
+            std::string filename = std::string("Sprites/") + (c == 0 ? "white-" : "black-") + pieceNames[pt] + ".png";
+            if (!images[c][pt].loadFromFile(filename)) {
+                std::cerr << "Error loading texture: " << filename << std::endl;
+                ok = false;
+                continue;
+            }
+            cell.x = std::max(cell.x, static_cast<int>(images[c][pt].getSize().x));
+            cell.y = std::max(cell.y, static_cast<int>(images[c][pt].getSize().y));
+        }
+    }
+    if (!ok) {
+        return;
+    }
+
+    sf::Image sheet;
+    sheet.create(cell.x * PIECE_TYPE_NB, cell.y * COLOR_NB, sf::Color::Transparent);
+    for (int c = 0; c < COLOR_NB; ++c) {
+        for (int pt = PAWN; pt <= KING; ++pt) {
+            sheet.copy(images[c][pt], pt * cell.x, c * cell.y);
+        }
+    }
+    loaded = atlas.loadFromImage(sheet);
+}
+
+TextureCache& TextureCache::instance() {
+    static TextureCache cache;
+    return cache;
+}
+
+sf::IntRect TextureCache::pieceRect(Color color, PieceType type) const {
+    return sf::IntRect(type * cell.x, colorIndex(color) * cell.y, cell.x, cell.y);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "Core/Types.h"
+
+// All piece sprites packed into one texture, loaded once on first use.
+// Pieces draw a sub-rectangle of the atlas instead of owning a texture,
+// so creating a piece (for example on promotion) never touches the disk.
+class TextureCache {
+private:
+    sf::Texture atlas;    // Sprites in a 6 x 2 grid, white on the top row, columns in PieceType order
+    sf::Vector2i cell;    // Size of one sprite cell in the atlas
+    bool loaded = false;
+
+    TextureCache();
+
+public:
+    // The cache shared by all pieces. Needs a window to exist first.
+    static TextureCache& instance();
+
+    const sf::Texture& getAtlas() const { return atlas; }
+
+    // Part of the atlas holding the sprite of the given piece
+    sf::IntRect pieceRect(Color color, PieceType type) const;
+
+    bool isLoaded() const { return loaded; }
+};
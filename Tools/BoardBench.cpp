@@ -0,0 +1,276 @@
+// Board benchmark: times the hot paths of the board and its rules in
+// nanoseconds per operation, to compare before and after a change.
+//
+// Each benchmark is run for a number of samples. A sample repeats the
+// operation for a batch sized so that it lasts at least --min-time
+// milliseconds, and the median, mean, standard deviation and range of the
+// samples are reported. With --json the results are written as JSON, to a
+// file or to stdout, for tracking regressions over time.
+//
+// Needs SFML like the game itself: link with Board.cpp, Piece.cpp,
+// TextureCache.cpp and Core. The window is hidden and frames are rendered
+// into an offscreen texture.
+//
+// Usage: boardbench [--samples N] [--min-time MS] [--json [file]]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../Board.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr const char* MIDDLEGAME_FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+    // Results are folded into this so the timed calls cannot be optimized away
+    volatile uintptr_t sink = 0;
+
+    struct Measurement {
+        std::string name;
+        uint64_t opsPerSample = 0;
+        std::vector<double> nsPerOp; // One value per sample
+        double median = 0;
+        double mean = 0;
+        double stddev = 0;
+        double min = 0;
+        double max = 0;
+    };
+
+    struct BenchOptions {
+        int samples = 15;
+        double minSampleMs = 5;
+    };
+
+    void summarize(Measurement& m) {
+        std::vector<double> sorted = m.nsPerOp;
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        m.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+        m.min = sorted.front();
+        m.max = sorted.back();
+
+        double sum = 0;
+        for (double v : sorted) {
+            sum += v;
+        }
+        m.mean = sum / n;
+        double squares = 0;
+        for (double v : sorted) {
+            squares += (v - m.mean) * (v - m.mean);
+        }
+        m.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+    }
+
+    // Time op, which performs opsPerCall operations per call. setup runs
+    // untimed before every sample. A batch never exceeds maxCalls calls, for
+    // operations that can only be repeated so often from one setup.
+    template <class Setup, class Op>
+    Measurement measure(const std::string& name, const BenchOptions& options, uint64_t opsPerCall,
+        Setup setup, Op op, uint64_t maxCalls = UINT64_MAX) {
+        auto timeBatch = [&](uint64_t calls) {
+            setup();
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < calls; ++i) {
+                op();
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        };
+
+        // Grow the batch until one sample is long enough to time reliably
+        uint64_t calls = 1;
+        while (calls < maxCalls && timeBatch(calls) < options.minSampleMs * 1e6) {
+            calls = std::min(calls * 2, maxCalls);
+        }
+
+        Measurement m;
+        m.name = name;
+        m.opsPerSample = calls * opsPerCall;
+        for (int i = 0; i < options.samples; ++i) {
+            m.nsPerOp.push_back(timeBatch(calls) / m.opsPerSample);
+        }
+        summarize(m);
+        return m;
+    }
+
+    template <class Op>
+    Measurement measure(const std::string& name, const BenchOptions& options, uint64_t opsPerCall, Op op) {
+        return measure(name, options, opsPerCall, [] {}, op);
+    }
+
+    // Pixel in the middle of a square, as a mouse click would give it
+    sf::Vector2i squareCenter(Square s) {
+        sf::Vector2i cell = toBoardPosition(s);
+        return sf::Vector2i(cell.x * 100 + 50, cell.y * 100 + 50);
+    }
+
+    void printTable(std::ostream& out, const std::vector<Measurement>& results) {
+        out << std::left << std::setw(28) << "benchmark" << std::right
+            << std::setw(12) << "median" << std::setw(12) << "mean"
+            << std::setw(12) << "stddev" << std::setw(12) << "min" << std::setw(12) << "max"
+            << "   ns/op\n";
+        out << std::fixed << std::setprecision(2);
+        for (const Measurement& m : results) {
+            out << std::left << std::setw(28) << m.name << std::right
+                << std::setw(12) << m.median << std::setw(12) << m.mean
+                << std::setw(12) << m.stddev << std::setw(12) << m.min << std::setw(12) << m.max << "\n";
+        }
+        out.flush();
+    }
+
+    void writeJson(std::ostream& out, const std::vector<Measurement>& results, const BenchOptions& options) {
+        out << std::setprecision(4) << std::fixed;
+        out << "{\n  \"unit\": \"ns/op\",\n  \"samples\": " << options.samples << ",\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Measurement& m = results[i];
+            out << "    {\"name\": \"" << m.name << "\""
+                << ", \"ops_per_sample\": " << m.opsPerSample
+                << ", \"median\": " << m.median
+                << ", \"mean\": " << m.mean
+                << ", \"stddev\": " << m.stddev
+                << ", \"min\": " << m.min
+                << ", \"max\": " << m.max
+                << ", \"values\": [";
+            for (size_t j = 0; j < m.nsPerOp.size(); ++j) {
+                out << (j ? ", " : "") << m.nsPerOp[j];
+            }
+            out << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    bool json = false;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) {
+            options.samples = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--min-time" && i + 1 < argc) {
+            options.minSampleMs = std::max(0.1, std::atof(argv[++i]));
+        }
+        else if (arg == "--json") {
+            json = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                jsonPath = argv[++i];
+            }
+        }
+        else {
+            std::cerr << "Usage: boardbench [--samples N] [--min-time MS] [--json [file]]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Board board(MIDDLEGAME_FEN);
+    board.setWindowVisible(false);
+    std::vector<Measurement> results;
+
+    // Square lookups, every square of the board per call
+    results.push_back(measure("getPieceAt", options, SQUARE_NB, [&] {
+        for (int y = 0; y < 8; ++y) {
+            for (int x = 0; x < 8; ++x) {
+                sink = sink + reinterpret_cast<uintptr_t>(board.getPieceAt(sf::Vector2i(x, y)));
+            }
+        }
+    }));
+
+    // Every pair of squares on a common line or diagonal
+    std::vector<std::pair<sf::Vector2i, sf::Vector2i>> lines;
+    for (Square from = 0; from < SQUARE_NB; ++from) {
+        for (Square to = 0; to < SQUARE_NB; ++to) {
+            if (from != to && (attacks(QUEEN, from) & squareBB(to))) {
+                lines.emplace_back(toBoardPosition(from), toBoardPosition(to));
+            }
+        }
+    }
+    results.push_back(measure("isPathClear", options, lines.size(), [&] {
+        for (const auto& line : lines) {
+            sink = sink + board.isPathClear(line.second, line.first);
+        }
+    }));
+
+    // Piece::isValidMove is gone, the rules of every piece kind live in
+    // Position. Time what placePiece asks it for a drop: finding the move of
+    // a piece to a square and checking that it is legal, for every piece of
+    // the side to move and every target square.
+    Position rules;
+    rules.setFen(MIDDLEGAME_FEN);
+    const char* kindNames[PIECE_TYPE_NB] = { "pawn", "knight", "bishop", "rook", "queen", "king" };
+    for (PieceType pt = PAWN; pt <= KING; pt = static_cast<PieceType>(pt + 1)) {
+        Bitboard origins = rules.pieces(rules.sideToMove(), pt);
+        results.push_back(measure(std::string("validateMove/") + kindNames[pt], options, popcount(origins) * SQUARE_NB, [&] {
+            for (Bitboard b = origins; b; ) {
+                Square from = popLsb(b);
+                for (Square to = 0; to < SQUARE_NB; ++to) {
+                    Move m = rules.findMove(from, to);
+                    sink = sink + (m != MOVE_NONE && rules.isLegal(m));
+                }
+            }
+        }));
+    }
+
+    // Not in check here, so nothing is printed
+    results.push_back(measure("checkForCheck", options, 1, [&] {
+        board.checkForCheck();
+    }));
+
+    // Whole drag and drop moves through selectPiece and placePiece: knights
+    // out and back for both sides, four moves per call. The fifty move rule
+    // would end the game, so each sample starts again from a fresh position.
+    const Square shuffle[4][2] = { { 6, 21 }, { 62, 45 }, { 21, 6 }, { 45, 62 } }; // g1f3 g8f6 f3g1 f6g8
+    results.push_back(measure("placePiece", options, 4,
+        [&] { board.loadFen(START_FEN); },
+        [&] {
+            for (const auto& move : shuffle) {
+                board.selectPiece(squareCenter(move[0]));
+                board.placePiece(squareCenter(move[1]));
+            }
+        },
+        24));
+
+    board.loadFen(MIDDLEGAME_FEN);
+    results.push_back(measure("rebuildPieceVertices", options, 1, [&] {
+        board.rebuildPieceVertices();
+    }));
+
+    // A whole frame into an offscreen texture of the window's size
+    sf::RenderTexture frame;
+    if (frame.create(800, 800)) {
+        results.push_back(measure("renderBoard/offscreen", options, 1, [&] {
+            frame.clear();
+            board.drawBoard(frame);
+            frame.display();
+        }));
+    }
+    else {
+        std::cerr << "Cannot create an offscreen texture, skipping renderBoard" << std::endl;
+    }
+
+    // The table goes to stderr when stdout carries the JSON
+    printTable(json && jsonPath.empty() ? std::cerr : std::cout, results);
+    if (json) {
+        if (jsonPath.empty()) {
+            writeJson(std::cout, results, options);
+        }
+        else {
+            std::ofstream out(jsonPath);
+            if (!out) {
+                std::cerr << "Cannot write " << jsonPath << std::endl;
+                return EXIT_FAILURE;
+            }
+            writeJson(out, results, options);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+// Opening book probe: lists the book moves of a position with their weights
+// and measures how long a probe takes.
+//
+// Usage: bookprobe <book.bin> ["<fen>"]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "../Core/Polyglot.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: bookprobe <book.bin> [\"<fen>\"]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    PolyglotBook book;
+    if (!book.open(argv[1])) {
+        std::cerr << "Cannot open " << argv[1] << " as a Polyglot book" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Position pos;
+    if (!pos.setFen(argc > 2 ? argv[2] : START_FEN)) {
+        std::cerr << "Invalid FEN" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    BookMove moves[64];
+    int count = book.probe(pos, moves, 64);
+    uint32_t total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += moves[i].weight;
+    }
+
+    std::cout << "Entries: " << book.size() << "\n"
+        << "Key: " << std::hex << polyglotKey(pos) << std::dec << "\n";
+    for (int i = 0; i < count; ++i) {
+        std::cout << moveToString(moves[i].move) << " weight " << moves[i].weight;
+        if (total > 0) {
+            std::cout << " (" << 100.0 * moves[i].weight / total << "%)";
+        }
+        std::cout << "\n";
+    }
+    if (count == 0) {
+        std::cout << "Out of book\n";
+    }
+
+    // Time repeated probes of the same position, the pages are warm after the first
+    constexpr int PROBES = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PROBES; ++i) {
+        book.bestMove(pos);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Probe: " << seconds * 1e9 / PROBES << " ns" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+// Perft: counts the leaf nodes of the legal move tree to verify the move
+// generator and to measure its speed.
+//
+// Usage: perft <depth> [fen] [--threads N] [--hash MB]
+//        perft --suite [--threads N] [--hash MB]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "../Core/Perft.h"
+
+namespace {
+
+    // Standard positions with known node counts, chosen to exercise
+    // castling, en passant, promotions, checks and pins
+    struct SuiteCase {
+        const char* fen;
+        int depth;
+        uint64_t nodes;
+    };
+
+    const SuiteCase suite[] = {
+        { START_FEN, 5, 4865609 },
+        { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603 },
+        { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083 },
+        { "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292 },
+        { "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 5, 15833292 },
+        { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487 },
+        // The en passant square cannot exist, no pawn passed it. Same count as with "-".
+        { "4k3/8/8/8/8/8/3PK3/8 w - e3 0 1", 5, 20187 },
+    };
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void printSpeed(uint64_t nodes, double seconds) {
+        std::cout << "Nodes: " << nodes << "\n"
+            << "Time: " << seconds << " s\n"
+            << "NPS: " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << std::endl;
+    }
+
+    int runSuite(int threads, size_t hashMb) {
+        int failures = 0;
+        uint64_t totalNodes = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const SuiteCase& test : suite) {
+            Position pos;
+            pos.setFen(test.fen);
+            PerftTable table(hashMb);
+
+            uint64_t nodes = 0;
+            for (const DivideEntry& entry : perftDivide(pos, test.depth, threads, &table)) {
+                nodes += entry.nodes;
+            }
+            totalNodes += nodes;
+
+            bool ok = nodes == test.nodes;
+            failures += ok ? 0 : 1;
+            std::cout << (ok ? "ok   " : "FAIL ") << test.fen << " depth " << test.depth
+                << ": " << nodes << " (expected " << test.nodes << ")" << std::endl;
+        }
+
+        printSpeed(totalNodes, secondsSince(start));
+        std::cout << (failures ? "Suite failed" : "Suite passed") << std::endl;
+        return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int depth = 0;
+    int threads = 1;
+    size_t hashMb = 0;
+    bool runSuiteOnly = false;
+    std::string fen;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--hash" && i + 1 < argc) {
+            hashMb = static_cast<size_t>(std::atoll(argv[++i]));
+        }
+        else if (arg == "--suite") {
+            runSuiteOnly = true;
+        }
+        else if (depth == 0) {
+            depth = std::atoi(arg.c_str());
+        }
+        else {
+            // FEN fields may come as separate arguments
+            fen += (fen.empty() ? "" : " ") + arg;
+        }
+    }
+
+    if (runSuiteOnly) {
+        return runSuite(threads, hashMb);
+    }
+
+    if (depth <= 0) {
+        std::cerr << "Usage: perft <depth> [fen] [--threads N] [--hash MB]\n"
+            << "       perft --suite [--threads N] [--hash MB]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Position pos;
+    if (!pos.setFen(fen.empty() ? START_FEN : fen)) {
+        std::cerr << "Invalid FEN: " << fen << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    PerftTable table(hashMb);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+
+    // Divide: node count below each root move
+    for (const DivideEntry& entry : perftDivide(pos, depth, threads, &table)) {
+        std::cout << moveToString(entry.move) << ": " << entry.nodes << "\n";
+        nodes += entry.nodes;
+    }
+    std::cout << std::endl;
+    printSpeed(nodes, secondsSince(start));
+    return EXIT_SUCCESS;
+}
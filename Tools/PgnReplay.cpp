@@ -0,0 +1,117 @@
+// PGN replay: memory-maps a PGN file, replays every game move by move and
+// reports the ingestion speed. Games with a move that is not legal in the
+// position reached are counted as errors.
+//
+// With --suite a set of small games, malformed ones included, is replayed
+// instead and the outcome of each is checked.
+//
+// Usage: pgnreplay <file> [--threads N]
+//        pgnreplay --suite
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "../Core/MappedFile.h"
+#include "../Core/Pgn.h"
+
+namespace {
+
+    // Games with the plies they replay to, or -1 for a parse error
+    struct SuiteCase {
+        const char* pgn;
+        int plies;
+    };
+
+    const SuiteCase suite[] = {
+        { "1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 1-0", 6 },
+        { "1. e4 {best by test} e5 (1... c5 2. Nf3 {Sicilian} (2. c3)) 2. Nf3 $1 *", 3 },
+        { "[FEN \"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1\"]\n\n1. O-O O-O-O 2. Rf7 *", 3 },
+        { "1. e4 ) e5 *", -1 },
+        { "1. e4 } e5 *", -1 },
+        { "1. e4 e5 ] *", -1 },
+        { "[Event \"unterminated\"\n\n1. e4 *", -1 },
+        { "1. e4 (1. d4 {open) e5 *", -1 },
+        { "1. e4 (1. d4 e5 *", -1 },
+        { "1. e4 {unterminated", -1 },
+        { "[FEN \"4k3/8/8/8/8/8/8/4K3 w K - 0 1\"]\n\n1. O-O *", -1 },
+        { "1. e4 e5 2. Ke3 *", -1 },
+    };
+
+    int runSuite() {
+        int failures = 0;
+        for (const SuiteCase& test : suite) {
+            Position pos;
+            int plies = 0;
+            int result = replayGame(test.pgn, pos, plies) ? plies : -1;
+            bool ok = result == test.plies;
+            failures += ok ? 0 : 1;
+            std::cout << (ok ? "ok   " : "FAIL ") << test.pgn << ": " << result
+                << " (expected " << test.plies << ")" << std::endl;
+        }
+
+        // Sharding must count the same games as a single thread
+        std::string games;
+        for (const SuiteCase& test : suite) {
+            games += "[Event \"suite\"]\n";
+            if (test.pgn[0] != '[') {
+                games += "\n";
+            }
+            games += test.pgn;
+            games += "\n\n";
+        }
+        PgnStats single = replayPgn(games.data(), games.size(), 1);
+        PgnStats sharded = replayPgn(games.data(), games.size(), 3);
+        bool ok = single.games == std::size(suite) && single.games == sharded.games
+            && single.plies == sharded.plies && single.errors == sharded.errors;
+        failures += ok ? 0 : 1;
+        std::cout << (ok ? "ok   " : "FAIL ") << "sharded replay: " << sharded.games << " games, "
+            << sharded.plies << " plies, " << sharded.errors << " errors" << std::endl;
+
+        std::cout << (failures ? "Suite failed" : "Suite passed") << std::endl;
+        return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    int threads = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--suite") {
+            return runSuite();
+        }
+        else {
+            path = arg;
+        }
+    }
+
+    if (path.empty()) {
+        std::cerr << "Usage: pgnreplay <file> [--threads N]\n"
+            << "       pgnreplay --suite" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return EXIT_FAILURE;
+    }
+    file.adviseSequential();
+
+    auto start = std::chrono::steady_clock::now();
+    PgnStats stats = replayPgn(file.data(), file.size(), threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Games: " << stats.games << "\n"
+        << "Plies: " << stats.plies << "\n"
+        << "Errors: " << stats.errors << "\n"
+        << "Time: " << seconds << " s\n"
+        << "Games/s: " << static_cast<uint64_t>(seconds > 0 ? stats.games / seconds : 0) << "\n"
+        << "Plies/s: " << static_cast<uint64_t>(seconds > 0 ? stats.plies / seconds : 0) << std::endl;
+    return stats.errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+// Search benchmark: searches a fixed set of positions to a fixed depth and
+// reports nodes and nodes per second. The total node count is a signature
+// of the search, any change to it means the search behaves differently.
+//
+// With --scaling the set is searched with 1, 2, 4, ... threads up to the
+// thread count and the time to reach the depth is compared to one thread.
+//
+// Usage: searchbench [depth] [--hash MB] [--threads N] [--scaling]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "../Core/Search.h"
+
+namespace {
+
+    const char* benchPositions[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 8",
+        "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+        "8/8/4k3/8/2K5/8/3P4/8 w - - 0 1",
+        "2r3k1/p4p2/3Rp2p/1p2P1pK/8/1P4P1/P3Q2P/1q6 b - - 0 1",
+    };
+
+    std::string scoreToString(int score) {
+        if (isMateScore(score)) {
+            return "mate " + std::to_string(mateInMoves(score));
+        }
+        return "cp " + std::to_string(score);
+    }
+
+    struct BenchTotals {
+        uint64_t nodes = 0;
+        double seconds = 0;
+    };
+
+    BenchTotals runBench(Engine& engine, int depth, bool verbose) {
+        SearchLimits limits;
+        limits.depth = depth;
+
+        BenchTotals totals;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const char* fen : benchPositions) {
+            Position pos;
+            pos.setFen(fen);
+            engine.clearHash();
+
+            SearchResult result = engine.search(pos, limits);
+            totals.nodes += result.nodes;
+            if (verbose) {
+                std::cout << fen << "\n  bestmove " << moveToString(result.bestMove)
+                    << " " << scoreToString(result.score)
+                    << " depth " << result.depth
+                    << " nodes " << result.nodes
+                    << " nps " << result.nps;
+                if (result.threadNodes.size() > 1) {
+                    std::cout << " per thread";
+                    for (uint64_t nodes : result.threadNodes) {
+                        std::cout << " " << nodes;
+                    }
+                }
+                std::cout << std::endl;
+            }
+        }
+
+        totals.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return totals;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int depth = 8;
+    size_t hashMb = 16;
+    int threads = 1;
+    bool scaling = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--hash" && i + 1 < argc) {
+            hashMb = static_cast<size_t>(std::atoll(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--scaling") {
+            scaling = true;
+        }
+        else {
+            depth = std::atoi(arg.c_str());
+        }
+    }
+
+    if (depth <= 0) {
+        std::cerr << "Usage: searchbench [depth] [--hash MB] [--threads N] [--scaling]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Engine engine;
+    engine.setHashSize(hashMb);
+
+    if (scaling) {
+        // Up to all hardware threads unless --threads says otherwise
+        int maxThreads = threads > 1 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        double baseSeconds = 0;
+        for (int n = 1; ; n = std::min(n * 2, maxThreads)) {
+            engine.setThreads(n);
+            BenchTotals totals = runBench(engine, depth, false);
+            if (n == 1) {
+                baseSeconds = totals.seconds;
+            }
+            std::cout << "Threads " << n
+                << " time " << totals.seconds << " s"
+                << " speedup " << (totals.seconds > 0 ? baseSeconds / totals.seconds : 0)
+                << " nodes " << totals.nodes
+                << " nps " << static_cast<uint64_t>(totals.seconds > 0 ? totals.nodes / totals.seconds : 0)
+                << std::endl;
+            if (n == maxThreads) {
+                break;
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    engine.setThreads(threads);
+    BenchTotals totals = runBench(engine, depth, true);
+    std::cout << "\nNodes: " << totals.nodes << "\n"
+        << "Time: " << totals.seconds << " s\n"
+        << "NPS: " << static_cast<uint64_t>(totals.seconds > 0 ? totals.nodes / totals.seconds : 0) << std::endl;
+    return EXIT_SUCCESS;
+}
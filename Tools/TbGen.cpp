@@ -0,0 +1,92 @@
+// Endgame tablebase generator and prober. Builds the tables for the given
+// material combinations (and everything they convert into) in a directory,
+// or looks a position up in the tables found there.
+//
+// Usage: tbgen <material>... [--dir D] [--threads N]
+//        tbgen --probe "<fen>" [--dir D]
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Core/Tablebase.h"
+
+namespace {
+
+    void printResult(const TbResult& result) {
+        if (result.wdl == TbWdl::DRAW) {
+            std::cout << "Draw" << std::endl;
+        }
+        else if (result.wdl == TbWdl::WIN) {
+            std::cout << "Win, mate in " << (result.plies + 1) / 2 << " (" << result.plies << " plies)" << std::endl;
+        }
+        else {
+            std::cout << "Loss, mated in " << result.plies / 2 << " (" << result.plies << " plies)" << std::endl;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string directory = "tablebases";
+    std::string probeFen;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> materials;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) {
+            directory = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--probe" && i + 1 < argc) {
+            probeFen = argv[++i];
+        }
+        else {
+            materials.push_back(arg);
+        }
+    }
+
+    if (!probeFen.empty()) {
+        Position pos;
+        if (!pos.setFen(probeFen)) {
+            std::cerr << "Invalid FEN" << std::endl;
+            return EXIT_FAILURE;
+        }
+        Tablebases tablebases;
+        tablebases.load(directory);
+        TbResult result;
+        if (!tablebases.probe(pos, result)) {
+            std::cout << "Not in the tablebases" << std::endl;
+            return EXIT_FAILURE;
+        }
+        printResult(result);
+        return EXIT_SUCCESS;
+    }
+
+    if (materials.empty()) {
+        std::cerr << "Usage: tbgen <material>... [--dir D] [--threads N]\n"
+            << "       tbgen --probe \"<fen>\" [--dir D]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto report = [](const TbGenerationStats& stats) {
+        std::cout << stats.name
+            << " positions " << stats.positions
+            << " wins " << stats.wins
+            << " draws " << stats.draws
+            << " losses " << stats.losses
+            << " longest mate " << stats.longestMate << " plies"
+            << " file " << stats.fileSize << " bytes"
+            << " time " << stats.seconds << " s" << std::endl;
+    };
+
+    for (const std::string& material : materials) {
+        if (!generateTablebase(material, directory, threads, report)) {
+            std::cerr << "Cannot generate " << material << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+// UCI engine: speaks the Universal Chess Interface on stdin and stdout so
+// the search can be driven by tournament managers and analysis GUIs.
+//
+// Commands are read on the main thread and the search runs on a background
+// thread, so stop and isready are answered while it searches. Supported:
+// uci, isready, ucinewgame, setoption (Threads, Hash, Clear Hash),
+// position startpos|fen ... [moves ...], go [depth N] [nodes N]
+// [movetime MS] [wtime MS] [btime MS] [winc MS] [binc MS] [movestogo N]
+// [infinite], stop, quit.
+//
+// Usage: uciengine
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Core/MoveGen.h"
+#include "../Core/Search.h"
+
+namespace {
+
+    constexpr int MAX_THREADS = 256;
+    constexpr int MAX_HASH_MB = 65536;
+    constexpr int64_t MOVE_OVERHEAD_MS = 30; // Kept in reserve for the GUI and the pipe
+    constexpr int DEFAULT_MOVES_TO_GO = 30;  // Moves the remaining time is spread over under sudden death
+
+    // Both threads write to stdout, one line at a time
+    std::mutex outputMutex;
+
+    void send(const std::string& line) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << line << std::endl;
+    }
+
+    std::string scoreToString(int score) {
+        if (isMateScore(score)) {
+            return "mate " + std::to_string(mateInMoves(score));
+        }
+        return "cp " + std::to_string(score);
+    }
+
+    // Legal move written in coordinate notation, or MOVE_NONE. Castling is the
+    // king's two-square step both in UCI and in Move.
+    Move parseMove(const Position& pos, const std::string& text) {
+        MoveList moves;
+        generate<LEGAL>(pos, moves);
+        for (Move m : moves) {
+            if (moveToString(m) == text) {
+                return m;
+            }
+        }
+        return MOVE_NONE;
+    }
+
+    // Milliseconds to spend on this move with the given clock, 0 for no clock
+    int64_t allocateTime(int64_t timeLeft, int64_t increment, int movesToGo) {
+        if (timeLeft <= 0) {
+            return 0;
+        }
+        int moves = movesToGo > 0 ? movesToGo : DEFAULT_MOVES_TO_GO;
+        int64_t budget = timeLeft / moves + increment * 3 / 4;
+        return std::max<int64_t>(1, std::min(budget, timeLeft - MOVE_OVERHEAD_MS));
+    }
+
+    class UciSession {
+    private:
+        Engine engine;
+        Position pos;
+        std::vector<uint64_t> history; // Keys of the positions before pos, for repetitions
+
+        // An infinite search keeps its best move until stop arrives
+        std::mutex stopMutex;
+        std::condition_variable stopSignal;
+        bool stopReceived = false;
+
+    public:
+        UciSession() {
+            pos.setStartPosition();
+        }
+
+        ~UciSession() {
+            stopSearch();
+        }
+
+        // Stop the background search, if any, and wait until it has sent its best move
+        void stopSearch() {
+            {
+                std::lock_guard<std::mutex> lock(stopMutex);
+                stopReceived = true;
+            }
+            stopSignal.notify_all();
+            engine.stop();
+            engine.wait();
+        }
+
+        void uci() {
+            send("id name Chess");
+            send("id author Chess contributors");
+            send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS));
+            send("option name Hash type spin default 16 min 1 max " + std::to_string(MAX_HASH_MB));
+            send("option name Clear Hash type button");
+            send("uciok");
+        }
+
+        // setoption name <id> [value <x>], the name may contain spaces
+        void setOption(std::istringstream& in) {
+            std::string token, name, value;
+            in >> token;
+            while (in >> token && token != "value") {
+                name += (name.empty() ? "" : " ") + token;
+            }
+            while (in >> token) {
+                value += (value.empty() ? "" : " ") + token;
+            }
+
+            stopSearch();
+            if (name == "Threads") {
+                engine.setThreads(std::clamp(std::atoi(value.c_str()), 1, MAX_THREADS));
+            }
+            else if (name == "Hash") {
+                engine.setHashSize(static_cast<size_t>(std::clamp(std::atoi(value.c_str()), 1, MAX_HASH_MB)));
+            }
+            else if (name == "Clear Hash") {
+                engine.clearHash();
+            }
+            else {
+                send("info string unknown option " + name);
+            }
+        }
+
+        // position startpos|fen <fen> [moves <move>...]
+        void setPosition(std::istringstream& in) {
+            std::string token, fen;
+            in >> token;
+            if (token == "startpos") {
+                fen = START_FEN;
+                in >> token;
+            }
+            else if (token == "fen") {
+                while (in >> token && token != "moves") {
+                    fen += token + " ";
+                }
+            }
+            else {
+                return;
+            }
+
+            Position next;
+            if (!next.setFen(fen)) {
+                send("info string bad fen " + fen);
+                return;
+            }
+            pos = next;
+            history.clear();
+            while (in >> token) {
+                Move m = parseMove(pos, token);
+                if (m == MOVE_NONE) {
+                    send("info string illegal move " + token);
+                    break;
+                }
+                history.push_back(pos.key());
+                pos.doMove(m);
+            }
+        }
+
+        void go(std::istringstream& in) {
+            SearchLimits limits;
+            int64_t time[COLOR_NB] = {};
+            int64_t increment[COLOR_NB] = {};
+            int movesToGo = 0;
+            bool infinite = false;
+
+            std::string token;
+            while (in >> token) {
+                if (token == "depth") in >> limits.depth;
+                else if (token == "nodes") in >> limits.nodes;
+                else if (token == "movetime") in >> limits.movetime;
+                else if (token == "wtime") in >> time[colorIndex(Color::WHITE)];
+                else if (token == "btime") in >> time[colorIndex(Color::BLACK)];
+                else if (token == "winc") in >> increment[colorIndex(Color::WHITE)];
+                else if (token == "binc") in >> increment[colorIndex(Color::BLACK)];
+                else if (token == "movestogo") in >> movesToGo;
+                else if (token == "infinite") infinite = true;
+            }
+            limits.depth = std::clamp(limits.depth, 1, MAX_PLY - 1);
+
+            int us = colorIndex(pos.sideToMove());
+            int64_t clockTime = allocateTime(time[us], increment[us], movesToGo);
+            if (clockTime > 0) {
+                limits.movetime = limits.movetime > 0 ? std::min(limits.movetime, clockTime) : clockTime;
+            }
+
+            stopSearch();
+            stopReceived = false;
+
+            auto onInfo = [](const SearchResult& result) {
+                std::string line = "info depth " + std::to_string(result.depth)
+                    + " score " + scoreToString(result.score)
+                    + " nodes " + std::to_string(result.nodes)
+                    + " nps " + std::to_string(result.nps)
+                    + " hashfull " + std::to_string(result.hashfull)
+                    + " time " + std::to_string(result.timeMs)
+                    + " pv";
+                for (Move m : result.pv) {
+                    line += " " + moveToString(m);
+                }
+                send(line);
+            };
+            auto onDone = [this, infinite](const SearchResult& result) {
+                if (infinite) {
+                    std::unique_lock<std::mutex> lock(stopMutex);
+                    stopSignal.wait(lock, [this] { return stopReceived; });
+                }
+                std::string line = "bestmove " + moveToString(result.bestMove);
+                if (result.pv.size() > 1) {
+                    line += " ponder " + moveToString(result.pv[1]);
+                }
+                send(line);
+            };
+            engine.start(pos, limits, history, onInfo, onDone);
+        }
+
+        // Handle one command line, returns false on quit
+        bool execute(const std::string& line) {
+            std::istringstream in(line);
+            std::string command;
+            in >> command;
+
+            if (command == "uci") uci();
+            else if (command == "isready") send("readyok");
+            else if (command == "setoption") setOption(in);
+            else if (command == "position") setPosition(in);
+            else if (command == "go") go(in);
+            else if (command == "stop") stopSearch();
+            else if (command == "ucinewgame") {
+                stopSearch();
+                engine.clearHash();
+            }
+            else if (command == "quit") return false;
+            else if (!command.empty()) send("info string unknown command " + command);
+            return true;
+        }
+    };
+}
+
+int main() {
+    UciSession session;
+    std::string line;
+    while (std::getline(std::cin, line) && session.execute(line)) {
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,6 +0,0 @@
-﻿// globals.cpp
-#include "globals.h"
-
-bool enPassantPossibility = false; // Изначально false
-bool gameOver = false;
-bool checkCheck = false;
\ No newline at end of file
@@ -1,5 +0,0 @@
-#pragma once
-
-extern bool enPassantPossibility;
-extern bool gameOver;
-extern bool checkCheck;
\ No newline at end of file
@@ -1,8 +1,39 @@
-﻿#include "Board.h"
+﻿#include <cstring>
+#include <iostream>
+#include "Board.h"
 
-int main() {
-    Board board;
+// Usage: chess ["<fen>"] [--book <book.bin>] [--tb <directory>]
+// Starts from the initial position without a FEN. With a Polyglot book the
+// board answers every move from the book for as long as it has one. With
+// endgame tablebases the game ends as soon as they cover the position.
+int main(int argc, char* argv[]) {
+    const char* fen = START_FEN;
+    const char* bookPath = nullptr;
+    const char* tablebasePath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--book") == 0 && i + 1 < argc) {
+            bookPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--tb") == 0 && i + 1 < argc) {
+            tablebasePath = argv[++i];
+        }
+        else {
+            fen = argv[i];
+        }
+    }
+
+    Board board(fen);
+    if (bookPath) {
+        if (board.loadBook(bookPath)) {
+            board.setBookAutoPlay(true);
+        }
+        else {
+            std::cerr << "Cannot open book " << bookPath << std::endl;
+        }
+    }
+    if (tablebasePath && board.loadTablebases(tablebasePath) == 0) {
+        std::cerr << "No tablebases in " << tablebasePath << std::endl;
+    }
     board.run();
     return 0;
 }
-